@@ -78,4 +78,39 @@
 #   endif
 #endif
 
+/*
+ * SIMD
+ */
+
+#if defined(__AVX2__)
+#   define _Z_SIMD_AVX2
+#endif
+#if defined(__SSSE3__) || defined(_Z_SIMD_AVX2)
+#   define _Z_SIMD_SSSE3
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define _Z_SIMD_SSE2
+#endif
+
+/*
+ * Sanitizers
+ */
+
+#if defined(__SANITIZE_ADDRESS__)
+#   define _Z_SANITIZE_ADDRESS
+#elif defined(__has_feature)
+#   if __has_feature(address_sanitizer)
+#       define _Z_SANITIZE_ADDRESS
+#   endif
+#endif
+
+// For kernels which read beyond terminators on purpose, see `load_is_page_safe`.
+#if !defined(_Z_SANITIZE_ADDRESS)
+#   define ZED_NO_SANITIZE_ADDRESS
+#elif defined(_MSC_VER)
+#   define ZED_NO_SANITIZE_ADDRESS  __declspec(no_sanitize_address)
+#else
+#   define ZED_NO_SANITIZE_ADDRESS  __attribute__((no_sanitize_address))
+#endif
+
 #endif // ZED_BUILD_MACROS_H
@@ -0,0 +1,174 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: config_watcher.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_CONFIG_WATCHER_HPP
+#define ZED_CONFIG_WATCHER_HPP
+
+#include "./platform_sdk.h"
+#ifdef _Z_OS_LINUX
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "./file/parser_source.hpp"
+#include "./file/watcher.hpp"
+#include "./mutex.hpp"
+#include "./parsers/ini.hpp"
+
+namespace zed {
+
+/**
+ * Config Watchers
+ *
+ * Watch an ini file with a `file_watcher` and reload it on its background thread once it is closed
+ * after writing or renamed into place, never while it is being written. Bursts of changes (e.g.
+ * editors writing and renaming) are debounced into one reload. Files which cannot be read, or are
+ * rejected by the validator, keep the previous version.
+ *
+ * Readers never lock in steady state: each reading thread owns a `reader`, which checks an atomic
+ * version and only copies the new `std::shared_ptr` (under a mutex) once after each reload.
+ *
+ *   config_watcher watcher("/etc/app.ini");
+ *   thread_local config_watcher::reader config(watcher);
+ *   int port = config->get_int("server", "port", 80);
+ */
+
+class config_watcher
+{
+public:
+    using validator = std::function<bool(const ini_data &)>;
+    static constexpr std::chrono::milliseconds default_debounce = std::chrono::milliseconds(200);
+
+    // Loads the file before returning.
+    explicit config_watcher(const char *path, std::chrono::milliseconds debounce = default_debounce, validator v = validator());
+
+    config_watcher(const config_watcher &) = delete;
+    config_watcher& operator=(const config_watcher &) = delete;
+
+    class reader;
+    std::shared_ptr<const ini_data> snapshot(void) const;
+    // Starts at 1, increases on each reload.
+    std::uint64_t version(void) const { return m_version.load(std::memory_order_acquire); }
+
+    // Reloads on the calling thread, returns false if the previous version is kept.
+    bool reload(void);
+private:
+    void on_changes(const file_watcher::change_set &changes);
+
+    const std::string m_path, m_file_name;
+    const validator m_validator;
+
+    zed::mutex m_reload_mutex; // Serializes reloads, so older files never win.
+    mutable zed::mutex m_mutex;
+    std::shared_ptr<const ini_data> m_current;
+    std::atomic<std::uint64_t> m_version{ 0 };
+
+    file_watcher m_watcher; // Last, so pending reloads finish with everything alive.
+};
+
+class config_watcher::reader
+{
+public:
+    explicit reader(const config_watcher &watcher) : m_watcher(watcher) {}
+
+    const ini_data& get(void);
+    const ini_data* operator->(void) { return &get(); }
+private:
+    const config_watcher &m_watcher;
+    std::shared_ptr<const ini_data> m_data;
+    std::uint64_t m_version = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+inline config_watcher::config_watcher(const char *path, std::chrono::milliseconds debounce, validator v)
+    : m_path(path)
+    , m_file_name(m_path.substr(m_path.rfind('/') + 1))
+    , m_validator(std::move(v))
+    , m_current(std::make_shared<const ini_data>(ini_data::parse_cstr("")))
+    , m_watcher([this](const file_watcher::change_set &changes) { on_changes(changes); }, debounce, file_watcher::completed_writes)
+{
+    // The directory is watched, as editors often replace files by renaming.
+    std::string dir = m_path.substr(0, m_path.length() - m_file_name.length());
+    m_watcher.watch(dir.empty() ? "." : dir.c_str());
+    if (!reload())
+    {
+        // Missing or rejected files start with empty data, readers need a version to pick it up.
+        std::uint64_t initial = 0;
+        m_version.compare_exchange_strong(initial, 1, std::memory_order_release);
+    }
+}
+
+inline void config_watcher::on_changes(const file_watcher::change_set &changes)
+{
+    for (const file_change &c : changes)
+    {
+        // Only the directory of the file is watched, so names are enough.
+        bool changed = file_change::removed != c.type && 0 == c.path.compare(c.path.rfind('/') + 1, std::string::npos, m_file_name);
+        if (changed || file_change::overflowed == c.type)
+        {
+            reload();
+            return;
+        }
+    }
+}
+
+inline bool config_watcher::reload(void)
+{
+    auto reloading = m_reload_mutex.guard();
+
+    int fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    basic_parser_stream<parser_file_source> stream(fd);
+    auto data = std::make_shared<const ini_data>(ini_data::parse_stream(stream));
+    bool failed = stream.source().failed();
+    ::close(fd);
+    if (failed || (m_validator && !m_validator(*data)))
+        return false;
+
+    if (auto _ = m_mutex.guard())
+    {
+        m_current = std::move(data);
+        m_version.fetch_add(1, std::memory_order_release);
+    }
+    return true;
+}
+
+inline std::shared_ptr<const ini_data> config_watcher::snapshot(void) const
+{
+    auto _ = m_mutex.guard();
+    return m_current;
+}
+
+inline const ini_data& config_watcher::reader::get(void)
+{
+    std::uint64_t version = m_watcher.version();
+    if (version != m_version)
+    {
+        m_data = m_watcher.snapshot();
+        m_version = version;
+    }
+    return *m_data;
+}
+
+} // namespace zed
+
+#endif // _Z_OS_LINUX
+
+#endif // ZED_CONFIG_WATCHER_HPP
@@ -12,17 +12,91 @@
 #ifndef ZED_CTYPE_HPP
 #define ZED_CTYPE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include "./simd.hpp"
 
 namespace zed {
 
+/**
+ * Char Sets
+ *
+ * A 256-bit bitmap, lookups take constant time no matter how many chars are in the set.
+ * Sets are usually built at compile time:
+ *
+ * constexpr char_set separators(",;");
+ *
+ * Only chars in [0, 255] can be members, wider chars are never contained.
+ */
+
+class char_set
+{
+public:
+    constexpr char_set(void) = default;
+    template <typename CharT>
+    constexpr explicit char_set(const CharT *chars)
+    {
+        for (; CharT() != *chars; ++chars)
+        {
+            unsigned i = index_of(*chars);
+            if (i < 256)
+                m_bits[i >> 6] |= std::uint64_t(1) << (i & 63);
+        }
+    }
+
+    template <typename CharT>
+    constexpr bool contains(CharT ch) const
+    {
+        unsigned i = index_of(ch);
+        return i < 256 && 0 != ((m_bits[i >> 6] >> (i & 63)) & 1);
+    }
+
+    constexpr char_set operator|(const char_set &o) const
+    {
+        char_set ret;
+        for (int i = 0; i < 4; ++i)
+            ret.m_bits[i] = m_bits[i] | o.m_bits[i];
+        return ret;
+    }
+    constexpr char_set operator~(void) const
+    {
+        char_set ret;
+        for (int i = 0; i < 4; ++i)
+            ret.m_bits[i] = ~m_bits[i];
+        return ret;
+    }
+
+    // Copies at most `capacity` members to `dst`, returns the number of all members.
+    size_t members(char *dst, size_t capacity) const;
+private:
+    template <typename CharT>
+    static constexpr unsigned index_of(CharT ch)
+    {
+        if constexpr (1 == sizeof(CharT))
+        {
+            return static_cast<unsigned char>(ch);
+        }
+        else
+        {
+            // Negative values are out of range as well.
+            std::make_unsigned_t<CharT> u = static_cast<std::make_unsigned_t<CharT>>(ch);
+            return u < 256 ? static_cast<unsigned>(u) : 256;
+        }
+    }
+
+    std::uint64_t m_bits[4] = { 0 };
+};
+
 template <typename CharT>
 struct ascii_whitespace
 {
     static constexpr CharT chars[] = { ' ', '\t', '\n', '\v', '\f', '\r', '\0' };
+    static constexpr char_set set = char_set(chars);
 };
 
-inline bool isspace(int ch) { return nullptr != ::strchr(ascii_whitespace<char>::chars, ch); }
+inline bool isspace(int ch) { return ascii_whitespace<char>::set.contains(ch); }
 
 /**
  * NOTE:
@@ -35,9 +109,131 @@ inline bool isspace(int ch) { return nullptr != ::strchr(ascii_whitespace<char>:
 
 inline bool islower(int ch) { return 'a' <= ch && ch <= 'z'; }
 inline bool isupper(int ch) { return 'A' <= ch && ch <= 'Z'; }
-inline bool isalpha(int ch) { return islower(ch) || isupper(ch); }
 inline bool isdigit(int ch) { return '0' <= ch && ch <= '9'; }
 
+// Looked up in a constexpr 256-entry table.
+bool isalpha(int ch);
+bool isalnum(int ch);
+bool isxdigit(int ch);
+bool ispunct(int ch);
+
+/**
+ * ASCII Case Folding
+ *
+ * Upper case ASCII letters are folded into lower case ones, other chars (including non-ASCII ones) are kept.
+ * Unlike `std::tolower`, no locales are involved.
+ */
+
+template <typename CharT>
+CharT fold_ascii_case(CharT ch);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+enum ctype_flags : unsigned char {
+    ctype_lower  = 0x01,
+    ctype_upper  = 0x02,
+    ctype_digit  = 0x04,
+    ctype_xdigit = 0x08,
+    ctype_punct  = 0x10,
+    ctype_alpha  = ctype_lower | ctype_upper,
+    ctype_alnum  = ctype_alpha | ctype_digit
+};
+
+struct ctype_table
+{
+    unsigned char values[256];
+
+    constexpr ctype_table(void) : values()
+    {
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            unsigned char flags = 0;
+            if ('a' <= i && i <= 'z')
+                flags |= ctype_lower;
+            if ('A' <= i && i <= 'Z')
+                flags |= ctype_upper;
+            if ('0' <= i && i <= '9')
+                flags |= ctype_digit | ctype_xdigit;
+            if (('a' <= i && i <= 'f') || ('A' <= i && i <= 'F'))
+                flags |= ctype_xdigit;
+            if ((0x21 <= i && i <= 0x2f) || (0x3a <= i && i <= 0x40) || (0x5b <= i && i <= 0x60) || (0x7b <= i && i <= 0x7e))
+                flags |= ctype_punct;
+            values[i] = flags;
+        }
+    }
+
+    bool test(int ch, unsigned char flags) const
+    {
+        return 0 <= ch && ch < 256 && 0 != (values[ch] & flags);
+    }
+};
+
+constexpr ctype_table ctype_classes;
+
+struct ascii_case_table
+{
+    unsigned char values[256];
+
+    constexpr ascii_case_table(bool upper) : values()
+    {
+        const unsigned first = upper ? 'a' : 'A';
+        for (unsigned i = 0; i < 256; ++i)
+            values[i] = static_cast<unsigned char>(first <= i && i < first + 26 ? i ^ 0x20 : i);
+    }
+};
+
+constexpr ascii_case_table ascii_fold(false), ascii_upper(true);
+
+} // namespace detail
+
+inline bool isalpha(int ch)
+{
+    return detail::ctype_classes.test(ch, detail::ctype_alpha);
+}
+
+inline bool isalnum(int ch)
+{
+    return detail::ctype_classes.test(ch, detail::ctype_alnum);
+}
+
+inline bool isxdigit(int ch)
+{
+    return detail::ctype_classes.test(ch, detail::ctype_xdigit);
+}
+
+inline bool ispunct(int ch)
+{
+    return detail::ctype_classes.test(ch, detail::ctype_punct);
+}
+
+inline size_t char_set::members(char *dst, size_t capacity) const
+{
+    size_t ret = 0;
+    for (unsigned h = 0; h < 8; ++h)
+    {
+        std::uint32_t bits = static_cast<std::uint32_t>(m_bits[h / 2] >> (h % 2 * 32));
+        for (; 0 != bits; bits &= bits - 1)
+        {
+            if (ret < capacity)
+                dst[ret] = static_cast<char>(h * 32 + detail::count_trailing_zeros(bits));
+            ++ret;
+        }
+    }
+    return ret;
+}
+
+template <typename CharT>
+CharT fold_ascii_case(CharT ch)
+{
+    if constexpr (1 == sizeof(CharT))
+        return static_cast<CharT>(detail::ascii_fold.values[static_cast<unsigned char>(ch)]);
+    else
+        return 0 <= ch && ch < 0x80 ? static_cast<CharT>(detail::ascii_fold.values[ch]) : ch;
+}
+
 } // namespace zed
 
 #endif // ZED_CTYPE_HPP
@@ -12,10 +12,20 @@
 #ifndef ZED_FILE_FILE_HPP
 #define ZED_FILE_FILE_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <cstring>
+#include <string>
+#include "../memory.hpp"
 #include "../platform_sdk.h"
-#ifdef _Z_OS_WINDOWS
+#if defined(_Z_OS_WINDOWS)
 #   include "../win/handled_resource.hpp"
+#elif defined(_Z_OS_POSIX)
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
 #endif
 
 namespace zed {
@@ -29,11 +39,29 @@ public:
     using path_t = const char *;
 #endif
 
-    static bool read(path_t path, std::string &dst);
+    static bool read(path_t path, std::string &dst) { return read_into(path, dst); }
+    // Reads into any resizable buffer of chars, e.g. `std::vector<char>`. Buffers keep their
+    // capacities, so ones reused across calls stop allocating once they fit the largest file.
+    template <class Buffer>
+    static bool read_into(path_t path, Buffer &dst);
 
+    // Files of at least `preallocation_threshold` bytes are allocated in one go before writing,
+    // which saves extent allocations and fragmentation (Linux only).
+    static constexpr size_t preallocation_threshold = 1024 * 1024;
     static bool write(path_t path, const void *data, size_t size);
     template <class Container>
     static bool write(path_t path, const Container &data) { return write(path, data.data(), data.size()); }
+
+    /**
+     * Atomic Writes
+     *
+     * Write a temporary file next to `path`, sync it, rename it over `path`, then sync the
+     * directory. Readers see either the old content or the new one, also after crashes. Replaced
+     * files keep their modes and owners, and are not replaced if their owners cannot be kept.
+     */
+    static bool write_atomic(path_t path, const void *data, size_t size);
+    template <class Container>
+    static bool write_atomic(path_t path, const Container &data) { return write_atomic(path, data.data(), data.size()); }
 };
 
 template <>
@@ -48,37 +76,250 @@ using unique_file = unique_resource<HANDLE, default_resource_finalizer<HANDLE>,
 using unique_file = unique_resource<FILE *>;
 #endif
 
+#ifdef _Z_OS_POSIX
+struct file_descriptor_finalizer
+{
+    void operator()(int fd) const { ::close(fd); }
+};
+
+struct file_descriptor_traits
+{
+    static constexpr int invalid_value = -1;
+};
+
+using unique_fd = unique_resource<int, file_descriptor_finalizer, file_descriptor_traits>;
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #ifdef _Z_OS_WINDOWS
-inline bool file::read(path_t path, std::string &dst)
+template <class Buffer>
+bool file::read_into(path_t path, Buffer &dst)
 {
-    unique_file file(::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr));
-    if (file)
+    dst.clear();
+
+    unique_file file(::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    if (!file)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file.get(), &size))
+        return false;
+
+    // `ReadFile` may return less than asked, e.g. on network shares.
+    dst.resize(static_cast<size_t>(size.QuadPart));
+    size_t total = 0;
+    while (total < dst.size())
     {
-        dst.clear();
-        DWORD size = ::GetFileSize(file.get(), nullptr);
-        if (size > 0)
-        {
-            dst.resize(size);
-            return ::ReadFile(file.get(), const_cast<char *>(dst.data()), dst.length(), &size, nullptr);
-        }
+        DWORD n;
+        DWORD to_read = static_cast<DWORD>(std::min<size_t>(dst.size() - total, MAXDWORD));
+        if (!::ReadFile(file.get(), &dst[0] + total, to_read, &n, nullptr))
+            return false;
+        if (0 == n)
+            break;
+        total += n;
     }
-    return false;
+    dst.resize(total);
+    return true;
 }
 
 inline bool file::write(path_t path, const void *data, size_t size)
 {
     unique_file file(::CreateFileW(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_ARCHIVE, nullptr));
-    if (file)
+    if (!file)
+        return false;
+
+    const char *p = static_cast<const char *>(data);
+    while (size > 0)
     {
         DWORD written;
-        return ::WriteFile(file.get(), data, size, &written, nullptr);
+        if (!::WriteFile(file.get(), p, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &written, nullptr))
+            return false;
+        p += written;
+        size -= written;
+    }
+    return true;
+}
+
+inline bool file::write_atomic(path_t path, const void *data, size_t size)
+{
+    static std::atomic<unsigned> s_counter{ 0 };
+    std::wstring tmp = std::wstring(path) + L"." + std::to_wstring(::GetCurrentProcessId()) + L"." + std::to_wstring(s_counter++) + L".tmp";
+
+    unique_file file(::CreateFileW(tmp.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_ARCHIVE, nullptr));
+    if (!file)
+        return false;
+
+    bool ok = true;
+    const char *p = static_cast<const char *>(data);
+    while (ok && size > 0)
+    {
+        DWORD written = 0;
+        ok = ::WriteFile(file.get(), p, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &written, nullptr);
+        p += written;
+        size -= written;
     }
+    ok = ok && ::FlushFileBuffers(file.get());
+    file.reset();
+
+    // Write-through returns once the rename is on the disk.
+    if (ok && ::MoveFileExW(tmp.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        return true;
+    ::DeleteFileW(tmp.c_str());
     return false;
 }
 #endif // _Z_OS_WINDOWS
 
+#ifdef _Z_OS_POSIX
+namespace detail {
+
+// Gives `fd` the owner and mode of the file at `path`, if there is one. Owners go first, as
+// changing them may clear set-user-ID bits.
+inline bool copy_owner_and_mode(const char *path, int fd)
+{
+    struct stat target, st;
+    if (0 != ::stat(path, &target))
+        return ENOENT == errno;
+    if (0 != ::fstat(fd, &st))
+        return false;
+
+    if ((target.st_uid != st.st_uid || target.st_gid != st.st_gid) && 0 != ::fchown(fd, target.st_uid, target.st_gid))
+        return false;
+    return (target.st_mode & 07777) == (st.st_mode & 07777) || 0 == ::fchmod(fd, target.st_mode & 07777);
+}
+
+inline int open_file(const char *path, int flags, mode_t mode = 0)
+{
+    int fd;
+#ifdef O_NOATIME
+    // Only allowed for owners of files, or privileged processes.
+    fd = ::open(path, flags | O_CLOEXEC | O_NOATIME, mode);
+    if (fd >= 0 || EPERM != errno)
+        return fd;
+#endif
+    do {
+        fd = ::open(path, flags | O_CLOEXEC, mode);
+    } while (fd < 0 && EINTR == errno);
+    return fd;
+}
+
+inline bool write_file_data(int fd, const void *data, size_t size)
+{
+#ifdef _Z_OS_LINUX
+    if (size >= file::preallocation_threshold)
+        ::fallocate(fd, 0, 0, static_cast<off_t>(size)); // Not supported by all file systems.
+#endif
+
+    const char *p = static_cast<const char *>(data);
+    while (size > 0)
+    {
+        ssize_t n = ::write(fd, p, size);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+                continue;
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool sync_directory_of(const char *path)
+{
+    const char *slash = std::strrchr(path, '/');
+    std::string dir = nullptr == slash ? std::string(".") : std::string(path, std::max<size_t>(slash - path, 1));
+
+    unique_fd fd(open_file(dir.c_str(), O_RDONLY | O_DIRECTORY));
+    return fd && 0 == ::fsync(fd.get());
+}
+
+} // namespace detail
+
+template <class Buffer>
+bool file::read_into(path_t path, Buffer &dst)
+{
+    dst.clear();
+
+    unique_fd fd(detail::open_file(path, O_RDONLY));
+    if (!fd)
+        return false;
+
+    struct stat st;
+    if (0 != ::fstat(fd.get(), &st))
+        return false;
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        // Sized by `fstat`, which is usually one `pread` then.
+        dst.resize(static_cast<size_t>(st.st_size));
+        size_t total = 0;
+        while (total < dst.size())
+        {
+            ssize_t n = ::pread(fd.get(), &dst[0] + total, dst.size() - total, static_cast<off_t>(total));
+            if (n < 0)
+            {
+                if (EINTR == errno)
+                    continue;
+                return false;
+            }
+            if (0 == n)
+                break; // Truncated meanwhile.
+            total += static_cast<size_t>(n);
+        }
+        dst.resize(total);
+        return true;
+    }
+
+    // Sizes of pipes and files in /proc are unknown, read them until the ends.
+    size_t total = 0;
+    for (;;)
+    {
+        if (total == dst.size())
+            dst.resize(std::max<size_t>(4096, 2 * total));
+        ssize_t n = ::read(fd.get(), &dst[0] + total, dst.size() - total);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+                continue;
+            return false;
+        }
+        if (0 == n)
+            break;
+        total += static_cast<size_t>(n);
+    }
+    dst.resize(total);
+    return true;
+}
+
+inline bool file::write(path_t path, const void *data, size_t size)
+{
+    unique_fd fd(detail::open_file(path, O_WRONLY | O_CREAT | O_TRUNC, 0666));
+    if (!fd || !detail::write_file_data(fd.get(), data, size))
+        return false;
+
+    // Errors of delayed writes may only be reported here, e.g. on NFS.
+    return 0 == ::close(fd.release());
+}
+
+inline bool file::write_atomic(path_t path, const void *data, size_t size)
+{
+    static std::atomic<unsigned> s_counter{ 0 };
+    std::string tmp = std::string(path) + '.' + std::to_string(::getpid()) + '.' + std::to_string(s_counter++) + ".tmp";
+
+    unique_fd fd(detail::open_file(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666));
+    if (!fd)
+        return false;
+
+    if (detail::copy_owner_and_mode(path, fd.get()) && detail::write_file_data(fd.get(), data, size)
+        && 0 == ::fdatasync(fd.get()) && 0 == ::rename(tmp.c_str(), path))
+        return detail::sync_directory_of(path);
+    ::unlink(tmp.c_str());
+    return false;
+}
+#endif // _Z_OS_POSIX
+
 } // namespace zed
 
 #endif // ZED_FILE_FILE_HPP
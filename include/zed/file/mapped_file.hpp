@@ -0,0 +1,223 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: mapped_file.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_FILE_MAPPED_FILE_HPP
+#define ZED_FILE_MAPPED_FILE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "../string.hpp"
+#include "./file.hpp"
+#ifdef _Z_OS_POSIX
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
+
+namespace zed {
+
+/**
+ * Mapped Files
+ *
+ * Map whole files into memory, so parsers and codecs can run on them without copying:
+ *
+ *   mapped_file file;
+ *   if (file.open(path, mapped_file::read_only, mapped_file::sequential | mapped_file::populate))
+ *       parse(file.view());
+ *
+ * Hints are only hints, failures of them are ignored:
+ *   - sequential: reads ahead aggressively, and drops pages behind early.
+ *   - will_need:  starts reading in asynchronously.
+ *   - huge_pages: backs the mapping with transparent huge pages, where the file system supports
+ *                 them (Linux only).
+ *   - populate:   reads everything in before `open` returns, so no page faults later (Linux only).
+ * Windows only takes `sequential`, which is passed to `CreateFile`.
+ *
+ * Empty files are opened with empty views, as they cannot be mapped.
+ */
+
+class mapped_file
+{
+public:
+    enum access_mode { read_only, read_write };
+    enum hint : unsigned {
+        no_hints   = 0x00,
+        sequential = 0x01,
+        will_need  = 0x02,
+        huge_pages = 0x04,
+        populate   = 0x08
+    };
+
+    mapped_file(void) = default;
+    mapped_file(mapped_file &&o) noexcept { swap(o); }
+    ~mapped_file(void) { close(); }
+
+    mapped_file& operator=(mapped_file &&o) noexcept;
+    mapped_file(const mapped_file &) = delete;
+    mapped_file& operator=(const mapped_file &) = delete;
+
+    bool open(file::path_t path, access_mode mode = read_only, unsigned hints = no_hints);
+    void close(void);
+    bool is_open(void) const { return m_open; }
+
+    const char* data(void) const { return m_data; }
+    // Only for `read_write` mappings.
+    char* data(void) { ZASSERT(read_write == m_mode); return m_data; }
+    size_t size(void) const { return m_size; }
+
+    string_piece<char> view(void) const { return string_piece<char>(m_data, m_size); }
+    // Clamped to the file.
+    string_piece<char> view(size_t offset, size_t length = SIZE_MAX) const;
+
+    // Advises a range, e.g. to prefetch the next part with `will_need`.
+    void advise(size_t offset, size_t length, unsigned hints) const;
+    // Writes dirty pages back, and waits for them.
+    bool flush(void);
+
+    void swap(mapped_file &o) noexcept;
+private:
+    char *m_data = nullptr;
+    size_t m_size = 0;
+    access_mode m_mode = read_only;
+    bool m_open = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+inline mapped_file& mapped_file::operator=(mapped_file &&o) noexcept
+{
+    mapped_file(std::move(o)).swap(*this);
+    return *this;
+}
+
+inline void mapped_file::advise(size_t offset, size_t length, unsigned hints) const
+{
+#ifdef _Z_OS_POSIX
+    if (offset >= m_size || 0 == length)
+        return;
+
+    // Ranges must start at pages.
+    size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = offset - offset % page_size;
+    length = std::min(length, m_size - offset) + (offset - begin);
+
+    char *p = m_data + begin;
+    if (hints & sequential)
+        ::madvise(p, length, MADV_SEQUENTIAL);
+    if (hints & will_need)
+        ::madvise(p, length, MADV_WILLNEED);
+#   ifdef MADV_HUGEPAGE
+    if (hints & huge_pages)
+        ::madvise(p, length, MADV_HUGEPAGE);
+#   endif
+#endif
+}
+
+inline void mapped_file::close(void)
+{
+    if (nullptr != m_data)
+    {
+#ifdef _Z_OS_WINDOWS
+        ::UnmapViewOfFile(m_data);
+#else
+        ::munmap(m_data, m_size);
+#endif
+        m_data = nullptr;
+    }
+    m_size = 0;
+    m_mode = read_only;
+    m_open = false;
+}
+
+inline bool mapped_file::flush(void)
+{
+    if (nullptr == m_data || read_write != m_mode)
+        return true;
+#ifdef _Z_OS_WINDOWS
+    return ::FlushViewOfFile(m_data, 0);
+#else
+    return 0 == ::msync(m_data, m_size, MS_SYNC);
+#endif
+}
+
+inline bool mapped_file::open(file::path_t path, access_mode mode, unsigned hints)
+{
+    close();
+
+    bool writable = read_write == mode;
+#ifdef _Z_OS_WINDOWS
+    DWORD flags = (hints & sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : 0;
+    unique_file file(::CreateFileW(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr));
+    if (!file)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file.get(), &size))
+        return false;
+    if (size.QuadPart > 0)
+    {
+        unique_resource<HANDLE> mapping(::CreateFileMappingW(file.get(), nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr));
+        if (!mapping)
+            return false;
+        m_data = static_cast<char *>(::MapViewOfFile(mapping.get(), writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        if (nullptr == m_data)
+            return false;
+        m_size = static_cast<size_t>(size.QuadPart);
+    }
+#else
+    unique_fd fd(::open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC));
+    if (!fd)
+        return false;
+
+    struct stat st;
+    if (0 != ::fstat(fd.get(), &st))
+        return false;
+    if (st.st_size > 0)
+    {
+        int flags = writable ? MAP_SHARED : MAP_PRIVATE;
+#   ifdef MAP_POPULATE
+        if (hints & populate)
+            flags |= MAP_POPULATE;
+#   endif
+        void *p = ::mmap(nullptr, st.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, flags, fd.get(), 0);
+        if (MAP_FAILED == p)
+            return false;
+        m_data = static_cast<char *>(p);
+        m_size = static_cast<size_t>(st.st_size);
+        advise(0, m_size, hints);
+    }
+#endif
+
+    m_mode = mode;
+    m_open = true;
+    return true;
+}
+
+inline void mapped_file::swap(mapped_file &o) noexcept
+{
+    std::swap(m_data, o.m_data);
+    std::swap(m_size, o.m_size);
+    std::swap(m_mode, o.m_mode);
+    std::swap(m_open, o.m_open);
+}
+
+inline string_piece<char> mapped_file::view(size_t offset, size_t length) const
+{
+    if (offset >= m_size)
+        return string_piece<char>();
+    return string_piece<char>(m_data + offset, std::min(length, m_size - offset));
+}
+
+} // namespace zed
+
+#endif // ZED_FILE_MAPPED_FILE_HPP
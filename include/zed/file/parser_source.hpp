@@ -0,0 +1,142 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: parser_source.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_FILE_PARSER_SOURCE_HPP
+#define ZED_FILE_PARSER_SOURCE_HPP
+
+#include <cstring>
+#include <memory>
+#include "../platform_sdk.h"
+#include "../string/parser.hpp"
+#ifdef _Z_OS_POSIX
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+namespace zed {
+
+/**
+ * File Parser Sources
+ *
+ * Read files, pipes or sockets through a fixed-size window, so any input can be parsed in
+ * constant memory. A refill keeps the token being taken and moves it to the front of the window,
+ * which only grows when a single token does not fit in it.
+ *
+ *   basic_parser_stream<parser_file_source> stream(fd);
+ *   ini_data ini = ini_data::parse_stream(stream);
+ *
+ * Files are not owned, and are read from their current positions.
+ */
+
+class parser_file_source
+{
+public:
+#ifdef _Z_OS_WINDOWS
+    using native_handle = HANDLE;
+#else
+    using native_handle = int;
+#endif
+    static constexpr size_t default_window_size = 64 * 1024;
+
+    explicit parser_file_source(native_handle file, size_t window_size = default_window_size);
+
+    const char* begin(void) const { return m_window.get(); }
+    bool at_window_end(const char *p) const { return p == m_end; }
+    int char_at(const char *p) const { return p < m_end ? *p : EOF; }
+    const char* find_first_of(const char *p, const char_set &set) const { return detail::find_first_in_range(p, m_end, set); }
+    const char* find_first_not_of(const char *p, const char_set &set) const { return detail::find_first_not_in_range(p, m_end, set); }
+    size_t offset_of(const char *p) const { return m_window_offset + (p - m_window.get()); }
+    bool refill(const char *&keep, const char *&p);
+
+    // Read errors end the input as well.
+    bool failed(void) const { return m_failed; }
+private:
+    size_t read(char *dst, size_t size);
+
+    native_handle m_file;
+    std::unique_ptr<char[]> m_window;
+    size_t m_capacity;
+    const char *m_end;
+    size_t m_window_offset = 0; // Of the window in the whole input.
+    bool m_eof = false, m_failed = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+inline parser_file_source::parser_file_source(native_handle file, size_t window_size)
+    : m_file(file), m_window(new char[window_size]), m_capacity(window_size), m_end(m_window.get())
+{
+    ZASSERT(window_size > 0);
+#if defined(_Z_OS_POSIX) && defined(POSIX_FADV_SEQUENTIAL)
+    // Doubles the kernel readahead, fails harmlessly on pipes and sockets.
+    ::posix_fadvise(m_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+inline size_t parser_file_source::read(char *dst, size_t size)
+{
+#ifdef _Z_OS_WINDOWS
+    DWORD n;
+    if (!::ReadFile(m_file, dst, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &n, nullptr))
+    {
+        // Pipes report their ends as broken.
+        m_failed = ERROR_BROKEN_PIPE != ::GetLastError();
+        n = 0;
+    }
+#else
+    ssize_t n;
+    do {
+        n = ::read(m_file, dst, size);
+    } while (n < 0 && EINTR == errno);
+    if (n < 0)
+    {
+        m_failed = true;
+        n = 0;
+    }
+#endif
+    if (0 == n)
+        m_eof = true;
+    return static_cast<size_t>(n);
+}
+
+inline bool parser_file_source::refill(const char *&keep, const char *&p)
+{
+    if (m_eof)
+        return false;
+
+    char *window = m_window.get();
+    size_t kept = m_end - keep, offset = p - keep; // `keep` and `p` may be the same variable.
+    m_window_offset += keep - window;
+    if (kept == m_capacity)
+    {
+        std::unique_ptr<char[]> grown(new char[2 * m_capacity]);
+        std::memcpy(grown.get(), keep, kept);
+        m_window = std::move(grown);
+        m_capacity *= 2;
+        window = m_window.get();
+    }
+    else if (keep != window)
+    {
+        std::memmove(window, keep, kept);
+    }
+
+    size_t n = read(window + kept, m_capacity - kept);
+    m_end = window + kept + n;
+    keep = window;
+    p = window + offset;
+    return n > 0;
+}
+
+} // namespace zed
+
+#endif // ZED_FILE_PARSER_SOURCE_HPP
@@ -0,0 +1,384 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: watcher.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_FILE_WATCHER_HPP
+#define ZED_FILE_WATCHER_HPP
+
+#include "../platform_sdk.h"
+#ifdef _Z_OS_LINUX
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../mutex.hpp"
+#include "../thread.hpp"
+#include "../threading/task_queue.hpp"
+
+namespace zed {
+
+/**
+ * File Watchers
+ *
+ * Watch directories with inotify, optionally with their subdirectories, and deliver changes in
+ * batches to a callback on a background `task_thread`:
+ *
+ *   file_watcher watcher([&cache](const file_watcher::change_set &changes) {
+ *       for (const file_change &c : changes)
+ *           file_change::overflowed == c.type ? cache.clear() : cache.erase(c.path);
+ *   });
+ *   watcher.watch("/srv/templates", true);
+ *
+ * Events are coalesced per path, a batch is delivered once no more events arrive within the
+ * latency, or at most `max_latency_factor` latencies after its first event. Subdirectories
+ * created in recursive watches are watched as well, and files found in them are reported as
+ * created, as they may be written before the watch is added.
+ *
+ * Files are reported as modified on every write by default. Watchers created with
+ * `completed_writes` only report files once they are closed after writing (as modified) or moved
+ * into place (as created), so readers never see them half written.
+ */
+
+struct file_change
+{
+    // `overflowed` changes have no paths, some events are lost and everything may have changed.
+    enum change_type { created, modified, removed, overflowed };
+
+    change_type type;
+    std::string path;
+};
+
+class file_watcher
+{
+public:
+    using change_set = std::vector<file_change>;
+    using callback = std::function<void(const change_set &)>;
+    static constexpr std::chrono::milliseconds default_latency = std::chrono::milliseconds(50);
+    static constexpr int max_latency_factor = 8;
+    enum report_mode { all_writes, completed_writes };
+
+    explicit file_watcher(callback cb, std::chrono::milliseconds latency = default_latency, report_mode mode = all_writes);
+    ~file_watcher(void);
+
+    file_watcher(const file_watcher &) = delete;
+    file_watcher& operator=(const file_watcher &) = delete;
+
+    bool watch(const char *dir, bool recursive = false);
+    void unwatch(const char *dir);
+private:
+    class deliver_task;
+    struct watch_entry {
+        std::string path;
+        bool recursive;
+    };
+
+    static constexpr std::uint32_t event_mask = IN_CREATE | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM;
+
+    static std::string normalize(const char *dir);
+    bool add_watches(const std::string &dir, bool recursive, bool report);
+    void remove_watches(const std::string &dir);
+    void record(file_change::change_type type, std::string path);
+    bool read_events(void);
+    void poll(void);
+
+    const callback m_callback;
+    const std::chrono::milliseconds m_latency;
+    const std::uint32_t m_reported_events;
+
+    zed::mutex m_mutex;
+    std::unordered_map<int, watch_entry> m_watches; // By watch descriptors.
+
+    // Only accessed by the polling thread.
+    change_set m_pending;
+    std::unordered_map<std::string, size_t> m_pending_index;
+
+    int m_inotify, m_wakeup;
+    task_thread m_worker;
+    thread<file_watcher> m_thread; // Last, so polling starts with everything constructed.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+class file_watcher::deliver_task final : public task_thread::task
+{
+public:
+    deliver_task(const callback &cb, change_set &&changes) : m_callback(cb), m_changes(std::move(changes)) {}
+private:
+    void run(void) override
+    {
+        m_callback(m_changes);
+        delete this;
+    }
+
+    const callback &m_callback;
+    change_set m_changes;
+};
+
+inline file_watcher::file_watcher(callback cb, std::chrono::milliseconds latency, report_mode mode)
+    : m_callback(std::move(cb))
+    , m_latency(latency)
+    , m_reported_events(completed_writes == mode ? IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM : event_mask)
+    , m_inotify(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , m_wakeup(::eventfd(0, EFD_CLOEXEC))
+    , m_worker()
+    , m_thread(this, &file_watcher::poll)
+{
+}
+
+inline file_watcher::~file_watcher(void)
+{
+    std::uint64_t one = 1;
+    if (m_wakeup >= 0)
+        ::write(m_wakeup, &one, sizeof(one));
+    m_thread.join();
+
+    if (m_inotify >= 0)
+        ::close(m_inotify);
+    if (m_wakeup >= 0)
+        ::close(m_wakeup);
+}
+
+inline bool file_watcher::add_watches(const std::string &dir, bool recursive, bool report)
+{
+    int wd = ::inotify_add_watch(m_inotify, dir.c_str(), event_mask | IN_ONLYDIR | IN_DONT_FOLLOW);
+    if (wd < 0)
+        return false;
+
+    if (auto _ = m_mutex.guard())
+    {
+        // Directories watched twice share their descriptors.
+        auto it = m_watches.find(wd);
+        if (m_watches.end() == it)
+            m_watches.emplace(wd, watch_entry{ dir, recursive });
+        else
+            it->second.recursive |= recursive;
+    }
+    if (!recursive && !report)
+        return true;
+
+    DIR *d = ::opendir(dir.c_str());
+    if (nullptr == d)
+        return true;
+    while (const dirent *e = ::readdir(d))
+    {
+        if ('.' == e->d_name[0] && ('\0' == e->d_name[1] || ('.' == e->d_name[1] && '\0' == e->d_name[2])))
+            continue;
+
+        std::string path = dir + '/' + e->d_name;
+        bool is_dir = DT_DIR == e->d_type;
+        if (DT_UNKNOWN == e->d_type)
+        {
+            struct stat st;
+            is_dir = 0 == ::lstat(path.c_str(), &st) && S_ISDIR(st.st_mode);
+        }
+
+        if (report)
+            record(file_change::created, path);
+        if (is_dir && recursive)
+            add_watches(path, recursive, report);
+    }
+    ::closedir(d);
+    return true;
+}
+
+inline std::string file_watcher::normalize(const char *dir)
+{
+    std::string ret(dir);
+    while (ret.length() > 1 && '/' == ret.back())
+        ret.pop_back();
+    return ret;
+}
+
+inline void file_watcher::poll(void)
+{
+    if (m_inotify < 0 || m_wakeup < 0)
+        return;
+
+    current_thread::set_name("file_watcher");
+
+    using clock = std::chrono::steady_clock;
+    clock::time_point deadline, last_deadline;
+    for (;;)
+    {
+        int timeout = -1;
+        if (!m_pending.empty())
+        {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+            timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+        }
+
+        pollfd fds[] = { { m_inotify, POLLIN, 0 }, { m_wakeup, POLLIN, 0 } };
+        int n = ::poll(fds, 2, timeout);
+        if (n < 0 && EINTR != errno)
+            return;
+        if (n > 0 && 0 != fds[1].revents)
+            return;
+
+        if (n > 0 && 0 != fds[0].revents)
+        {
+            bool was_empty = m_pending.empty();
+            if (read_events() && !m_pending.empty())
+            {
+                clock::time_point now = clock::now();
+                if (was_empty)
+                    last_deadline = now + m_latency * max_latency_factor;
+                deadline = std::min(now + m_latency, last_deadline);
+            }
+        }
+        if (!m_pending.empty() && clock::now() >= deadline)
+        {
+            m_pending_index.clear();
+            m_worker.add(new deliver_task(m_callback, std::move(m_pending)));
+            m_pending.clear();
+        }
+    }
+}
+
+inline bool file_watcher::read_events(void)
+{
+    alignas(inotify_event) char buf[4096];
+    bool changed = false;
+    for (;;)
+    {
+        ssize_t n = ::read(m_inotify, buf, sizeof(buf));
+        if (n <= 0)
+            return changed;
+
+        for (const char *p = buf; p < buf + n;)
+        {
+            const inotify_event *e = reinterpret_cast<const inotify_event *>(p);
+            p += sizeof(inotify_event) + e->len;
+
+            changed = true;
+            if (IN_Q_OVERFLOW & e->mask)
+            {
+                record(file_change::overflowed, std::string());
+                continue;
+            }
+
+            std::string path;
+            bool recursive = false;
+            if (auto _ = m_mutex.guard())
+            {
+                auto it = m_watches.find(e->wd);
+                if (m_watches.end() == it)
+                    continue;
+                if (IN_IGNORED & e->mask)
+                {
+                    // Removed, or the directory is gone.
+                    m_watches.erase(it);
+                    continue;
+                }
+                if (0 == e->len)
+                    continue;
+                path = it->second.path + '/' + e->name;
+                recursive = it->second.recursive;
+            }
+
+            // Directories are still watched as they are created, even if not reported.
+            if ((IN_CREATE | IN_MOVED_TO) & e->mask)
+            {
+                if ((IN_ISDIR & e->mask) && recursive)
+                    add_watches(path, true, true);
+            }
+            if (0 == (m_reported_events & e->mask))
+                continue;
+
+            if ((IN_CREATE | IN_MOVED_TO) & e->mask)
+            {
+                record(file_change::created, std::move(path));
+            }
+            else if ((IN_DELETE | IN_MOVED_FROM) & e->mask)
+            {
+                // Watches of directories moved away would report wrong paths.
+                if ((IN_ISDIR & e->mask) && (IN_MOVED_FROM & e->mask))
+                    remove_watches(path);
+                record(file_change::removed, std::move(path));
+            }
+            else
+            {
+                record(file_change::modified, std::move(path));
+            }
+        }
+    }
+}
+
+inline void file_watcher::record(file_change::change_type type, std::string path)
+{
+    auto r = m_pending_index.emplace(path, m_pending.size());
+    if (r.second)
+    {
+        m_pending.push_back({ type, std::move(path) });
+        return;
+    }
+
+    // Replaced paths are modified, and removals win over earlier changes.
+    file_change::change_type &t = m_pending[r.first->second].type;
+    switch (type)
+    {
+        case file_change::created:
+            t = file_change::removed == t ? file_change::modified : file_change::created;
+            break;
+        case file_change::modified:
+            if (file_change::removed == t)
+                t = file_change::modified;
+            break;
+        default:
+            t = type;
+    }
+}
+
+inline void file_watcher::remove_watches(const std::string &dir)
+{
+    std::string prefix = dir + '/';
+
+    auto _ = m_mutex.guard();
+    for (auto it = m_watches.begin(); m_watches.end() != it;)
+    {
+        const std::string &path = it->second.path;
+        if (path == dir || 0 == path.compare(0, prefix.length(), prefix))
+        {
+            ::inotify_rm_watch(m_inotify, it->first);
+            it = m_watches.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+inline void file_watcher::unwatch(const char *dir)
+{
+    remove_watches(normalize(dir));
+}
+
+inline bool file_watcher::watch(const char *dir, bool recursive)
+{
+    return m_inotify >= 0 && add_watches(normalize(dir), recursive, false);
+}
+
+} // namespace zed
+
+#endif // _Z_OS_LINUX
+
+#endif // ZED_FILE_WATCHER_HPP
@@ -23,63 +23,106 @@ namespace zed {
 template <typename... Args>
 void log(const char *fmt, const Args&... args);
 
+template <class Literal, typename... Args>
+void log(const format_string<Literal> &fmt, const Args&... args);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementations
 
 struct log_serializer {
     template <typename T>
     static void push(std::vector<std::string> &dst, const T &arg) {
-        static_assert(false, "Not implemented!");
+        static_assert(sizeof(T) == 0, "Not implemented!");
     }
 
     static void push(std::vector<std::string> &dst, bool b) {
         push(dst, b ? "true" : "false");
     }
     static void push(std::vector<std::string> &dst, short s) {
-        push(dst, std::to_string(s));
+        push_number(dst, s);
     }
     static void push(std::vector<std::string> &dst, unsigned short us) {
-        push(dst, std::to_string(us));
+        push_number(dst, us);
     }
     static void push(std::vector<std::string> &dst, int n) {
-        push(dst, std::to_string(n));
+        push_number(dst, n);
     }
     static void push(std::vector<std::string> &dst, unsigned int u) {
-        push(dst, std::to_string(u));
+        push_number(dst, u);
     }
     static void push(std::vector<std::string> &dst, long l) {
-        push(dst, std::to_string(l));
+        push_number(dst, l);
     }
     static void push(std::vector<std::string> &dst, unsigned long ul) {
-        push(dst, std::to_string(ul));
+        push_number(dst, ul);
+    }
+    static void push(std::vector<std::string> &dst, long long ll) {
+        push_number(dst, ll);
+    }
+    static void push(std::vector<std::string> &dst, unsigned long long ull) {
+        push_number(dst, ull);
+    }
+    static void push(std::vector<std::string> &dst, float f) {
+        push_number(dst, f);
+    }
+    static void push(std::vector<std::string> &dst, double d) {
+        push_number(dst, d);
+    }
+    template <typename T>
+    static void push(std::vector<std::string> &dst, T *p) {
+        push_number(dst, p);
     }
     static void push(std::vector<std::string> &dst, const std::string &s) {
         dst.emplace_back(s);
     }
+    static void push(std::vector<std::string> &dst, const string_piece<char> &s) {
+        dst.emplace_back(s.data(), s.length());
+    }
     static void push(std::vector<std::string> &dst, const char *psz) {
         dst.emplace_back(psz);
     }
+private:
+    template <typename T>
+    static void push_number(std::vector<std::string> &dst, T n) {
+        number_buffer buf;
+        string_piece<char> s = format_number(buf, n);
+        dst.emplace_back(s.data(), s.length());
+    }
 };
 
-template <typename... Args>
-void log(const char *fmt, const Args&... args)
+namespace detail {
+
+inline void output_log(const string_piece<char> &s)
 {
-    args_collector<log_serializer> ac;
-    std::string s = detail::sequence_format(ac, fmt, args...);
 #ifdef _Z_OS_WINDOWS
-    std::wstring ws = multi_byte_to_wide_string(s);
+    std::wstring ws;
+    utf8_to_utf16(s, ws);
     ws.append(L"\r\n");
     ::OutputDebugStringW(ws.c_str());
 #endif
 }
 
+} // namespace detail
+
+template <typename... Args>
+void log(const char *fmt, const Args&... args)
+{
+    std::string s;
+    detail::sequence_format_to<log_serializer>(s, fmt, args...);
+    detail::output_log(string_piece<char>(s));
+}
+
+template <class Literal, typename... Args>
+void log(const format_string<Literal> &fmt, const Args&... args)
+{
+    std::string s;
+    detail::sequence_format_to<log_serializer>(s, fmt, args...);
+    detail::output_log(string_piece<char>(s));
+}
+
 inline void log(const char *s)
 {
-#ifdef _Z_OS_WINDOWS
-    std::wstring ws = multi_byte_to_wide_string(s);
-    ws.append(L"\r\n");
-    ::OutputDebugStringW(ws.c_str());
-#endif
+    detail::output_log(string_piece<char>(s, std::char_traits<char>::length(s)));
 }
 
 } // namespace zed
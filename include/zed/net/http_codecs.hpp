@@ -14,6 +14,8 @@
 
 #include <unordered_map>
 #include "../string/algorithm.hpp"
+#include "../string/builder.hpp"
+#include "../string/inline_string.hpp"
 
 namespace zed {
 
@@ -23,34 +25,41 @@ std::string decode_uri_component(const string_piece<char> &s);
 std::string encode_uri_component(const char *psz);
 std::string encode_uri_component(const string_piece<char> &s);
 
+// Keys up to 31 chars are stored inline.
+using form_data = std::unordered_map<inline_string<31, inline_spill::heap>, std::string>;
+
+// Maps of string-like pairs, e.g. `form_data`.
+template <class Map>
+std::string url_encode(const Map &form_data);
 std::string url_encode(const std::unordered_map<std::string, std::string> &form_data);
 
-std::unordered_map<std::string, std::string> url_decode(const string_piece<char> &s);
+// Other maps can be asked for, e.g. `url_decode<std::unordered_map<std::string, std::string>>(s)`.
+template <class Map = form_data>
+Map url_decode(const string_piece<char> &s);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementations
 
 namespace detail {
 
-inline void append_encoded(std::string &s, char ch)
+constexpr char_set uri_unreserved("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_.!~*'()");
+
+// `Dst` is a `std::string` or a `string_builder`.
+template <class Dst>
+void append_encoded(Dst &dst, char ch)
 {
-    constexpr char special_chars[] = "-_.!~*'()";
     constexpr char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
-    if (zed::isdigit(ch) || zed::isalpha(ch) || nullptr != strchr(special_chars, ch))
+    ZASSERT(!uri_unreserved.contains(ch));
+    if (' ' == ch)
     {
-        s.push_back(ch);
-    }
-    else if (' ' == ch)
-    {
-        s.push_back('+');
+        dst.push_back('+');
     }
     else
     {
         unsigned char b = static_cast<unsigned char>(ch);
-        s.push_back('%');
-        s.push_back(hex_digits[(b >> 4)]);
-        s.push_back(hex_digits[(b & 0xf)]);
+        const char encoded[] = { '%', hex_digits[(b >> 4)], hex_digits[(b & 0xf)] };
+        dst.append(encoded, 3);
     }
 }
 
@@ -99,16 +108,23 @@ std::string decode_uri_component(CharIterator &it)
     return ret;
 }
 
-template <class CharIterator>
-std::string encode_uri_component(CharIterator &it)
+template <class Dst>
+void encode_uri_component(const string_piece<char> &s, Dst &dst)
 {
-    std::string ret;
-    while (!it.reach_the_end())
+    size_t i = 0;
+    while (i < s.length())
     {
-        append_encoded(ret, *it);
-        ++it;
+        // Unreserved chars are copied in runs.
+        size_t p = zed::find_first_not_of(s, uri_unreserved, i);
+        if (string_piece<char>::npos == p)
+            p = s.length();
+        dst.append(s.data() + i, p - i);
+        if (p == s.length())
+            break;
+
+        append_encoded(dst, s[p]);
+        i = p + 1;
     }
-    return ret;
 }
 
 } // namespace detail
@@ -127,53 +143,78 @@ inline std::string decode_uri_component(const string_piece<char> &s)
 
 inline std::string encode_uri_component(const char *psz)
 {
-    detail::char_iterator it(psz);
-    return detail::encode_uri_component(it);
+    return encode_uri_component(string_piece<char>(psz, strlen(psz)));
 }
 
 inline std::string encode_uri_component(const string_piece<char> &s)
 {
-    detail::char_iterator it(s);
-    return detail::encode_uri_component(it);
+    size_t estimate = s.length() + s.length() / 2;
+    if (estimate < string_builder::min_worthwhile_size)
+    {
+        std::string ret;
+        ret.reserve(estimate);
+        detail::encode_uri_component(s, ret);
+        return ret;
+    }
+
+    string_builder ret;
+    ret.reserve_hint(estimate);
+    detail::encode_uri_component(s, ret);
+    return ret.str();
 }
 
-inline std::unordered_map<std::string, std::string> url_decode(const string_piece<char> &s)
+template <class Map>
+Map url_decode(const string_piece<char> &s)
 {
-    std::unordered_map<std::string, std::string> ret;
-    auto pairs = split(s, "&");
-    for (const auto &pair : pairs)
+    Map ret;
+    for (const string_piece<char> &pair : split_view(s, "&"))
     {
-        std::string k, v;
-
         size_t p = pair.find('=');
         if (string_piece<char>::npos != p)
-        {
-            k = decode_uri_component(pair.substr(0, p));
-            v = decode_uri_component(pair.substr(p + 1));
-        }
+            ret.emplace(decode_uri_component(pair.substr(0, p)), decode_uri_component(pair.substr(p + 1)));
         else
-        {
             ret.emplace(decode_uri_component(pair), std::string());
-        }
-
-        ret.emplace(k, v);
     }
     return ret;
 }
 
-inline std::string url_encode(const std::unordered_map<std::string, std::string> &form_data)
+template <class Map>
+std::string url_encode(const Map &form_data)
 {
-    std::string ret;
-
+    size_t length = 0;
     for (const auto &it : form_data)
+        length += it.first.length() + it.second.length() + 2;
+
+    auto encode_to = [&form_data](auto &dst) {
+        for (const auto &it : form_data)
+        {
+            if (!dst.empty())
+                dst.push_back('&');
+
+            detail::encode_uri_component(string_piece<char>(it.first), dst);
+            dst.push_back('=');
+            detail::encode_uri_component(string_piece<char>(it.second), dst);
+        }
+    };
+
+    size_t estimate = length + length / 2;
+    if (estimate < string_builder::min_worthwhile_size)
     {
-        ret.append(encode_uri_component(it.first)).push_back('=');
-        ret.append(encode_uri_component(it.second)).push_back('&');
+        std::string ret;
+        ret.reserve(estimate);
+        encode_to(ret);
+        return ret;
     }
 
-    if (!ret.empty())
-        ret.pop_back();
-    return ret;
+    string_builder ret;
+    ret.reserve_hint(estimate);
+    encode_to(ret);
+    return ret.str();
+}
+
+inline std::string url_encode(const std::unordered_map<std::string, std::string> &form_data)
+{
+    return url_encode<std::unordered_map<std::string, std::string>>(form_data);
 }
 
 } // namespace zed
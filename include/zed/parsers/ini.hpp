@@ -12,12 +12,20 @@
 #ifndef ZED_PARSERS_INI_HPP
 #define ZED_PARSERS_INI_HPP
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
+#include <vector>
 #include "../string/algorithm.hpp"
+#include "../string/inline_string.hpp"
 #include "../string/parser.hpp"
 
 namespace zed {
 
+class frozen_ini_data;
+
 class ini_data
 {
 public:
@@ -25,18 +33,74 @@ public:
     static ini_data parse_string(const String &s);
     static ini_data parse_cstr(const char *psz);
     static ini_data parse_stream(parser_stream &stream);
+    template <class Source>
+    static ini_data parse_stream(basic_parser_stream<Source> &stream);
 
     int get_int(const char *sec, const char *name, int def) const;
     std::string get_string(const char *sec, const char *name, const char *def = "") const;
 
-    using section = std::unordered_map<std::string, std::string>;
+    // Names up to 31 chars are stored inline.
+    using key = inline_string<31, inline_spill::heap>;
+    using section = std::unordered_map<key, std::string>;
     const section* get_section(const char *sec) const;
+
+    // Compiles the data into a read-only table for hot paths.
+    frozen_ini_data freeze(void) const;
 private:
     ini_data(void) = default;
 
+    template <class Stream>
+    static ini_data parse(Stream &stream);
+
     const std::string* get_value(const char *sec, const char *name) const;
 
-    std::unordered_map<std::string, section> m_sections;
+    std::unordered_map<key, section> m_sections;
+};
+
+/**
+ * Frozen INI Data
+ *
+ * All keys are laid out in one flat table, indexed by a minimal perfect hash of (section, name)
+ * built with hash-and-displace: keys are hashed into buckets of about 2 keys, and each bucket gets
+ * a displacement which sends its keys to free slots, buckets of a single key get their slots
+ * directly. A lookup hashes the pieces it is given once, then reads one displacement and one
+ * entry, no temporaries involved.
+ */
+
+class frozen_ini_data
+{
+public:
+    frozen_ini_data(void) = default;
+
+    bool contains(const string_piece<char> &sec, const string_piece<char> &name) const { return nullptr != find(sec, name); }
+    int get_int(const string_piece<char> &sec, const string_piece<char> &name, int def) const;
+    // Pieces are valid as long as the frozen data.
+    string_piece<char> get_string(const string_piece<char> &sec, const string_piece<char> &name, const string_piece<char> &def = string_piece<char>()) const;
+
+    size_t size(void) const { return m_entries.size(); }
+private:
+    friend class ini_data;
+
+    struct entry {
+        std::uint32_t fingerprint; // High bits of the hash.
+        std::uint32_t section, section_length;
+        std::uint32_t name, name_length;
+        std::uint32_t value, value_length;
+    };
+
+    static std::uint64_t hash(const string_piece<char> &sec, const string_piece<char> &name, std::uint64_t seed);
+    static size_t reduce(std::uint64_t h, size_t n) { return static_cast<size_t>((h & 0xffffffff) * n >> 32); }
+    static size_t slot_of(std::uint64_t h, std::uint32_t displacement, size_t n);
+    static constexpr std::uint32_t direct_slot = 0x80000000;
+
+    string_piece<char> chars(std::uint32_t offset, std::uint32_t length) const { return string_piece<char>(m_chars.data() + offset, length); }
+    const entry* find(const string_piece<char> &sec, const string_piece<char> &name) const;
+    bool build(const std::vector<std::uint64_t> &hashes, std::vector<std::uint32_t> &slots);
+
+    std::uint64_t m_seed = 0;
+    std::vector<std::uint32_t> m_displacements;
+    std::vector<entry> m_entries;
+    std::string m_chars;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,25 +108,58 @@ private:
 
 namespace detail {
 
-struct ini_token
+struct ini_token_base
 {
     enum token_type { unexpected = -1, finished = 0, comment, section, key, value };
 
     token_type type;
-    std::string data;
 
-    ini_token(token_type t = unexpected) : type(t) {}
+    ini_token_base(token_type t) : type(t) {}
     bool is_finished(void) const { return finished == type; }
 };
 
+struct ini_token : ini_token_base
+{
+    std::string data;
+
+    ini_token(token_type t = unexpected) : ini_token_base(t) {}
+
+    void append(const string_piece<char> &s) { data.append(s.data(), s.length()); }
+    void push_back(char ch) { data.push_back(ch); }
+    void trim(void) { zed::trim(&data); }
+    void trim_right(void) { zed::trim_right(&data); }
+};
+
+// Refers to the input while its chars are contiguous, so the input must outlive the token.
+class ini_span_token : public ini_token_base
+{
+public:
+    ini_span_token(token_type t = unexpected) : ini_token_base(t) {}
+
+    string_piece<char> data(void) const { return m_materialized ? string_piece<char>(m_buffer) : m_span; }
+    bool materialized(void) const { return m_materialized; }
+
+    void append(const string_piece<char> &s);
+    void push_back(char ch);
+    void trim(void);
+    void trim_right(void);
+private:
+    void materialize(void);
+
+    string_piece<char> m_span;
+    std::string m_buffer;
+    bool m_materialized = false;
+};
+
+template <class Stream, class Token = ini_token>
 class ini_tokenizer
 {
 public:
-    ini_tokenizer(parser_stream &stream) : m_stream(stream) {}
+    ini_tokenizer(Stream &stream) : m_stream(stream) {}
 
-    ini_token get(void)
+    Token get(void)
     {
-        ini_token ret;
+        Token ret;
         int ch = m_stream.peek();
         switch (ch)
         {
@@ -81,10 +178,10 @@ public:
         }
         return ret;
     }
-    ini_token get_value(void)
+    Token get_value(void)
     {
-        ini_token ret;
-        int ch = m_stream.peek(" \t");
+        Token ret;
+        int ch = m_stream.peek(blanks);
         if ('\'' == ch || '"' == ch)
             parse_quoted_value(ch, ret);
         else
@@ -92,20 +189,16 @@ public:
         return ret;
     }
 private:
-    void parse_section_header(ini_token &dst)
+    void parse_section_header(Token &dst)
     {
-        int ch;
-        while ((ch = m_stream.advance()) != EOF)
-        {
-            if ('\n' == ch || ']' == ch)
-                break;
-            dst.data.push_back(ch);
-        }
+        m_stream.advance();
+        dst.append(m_stream.take_until(section_stops));
 
+        int ch = m_stream.current_char();
         if (']' == ch)
         {
             dst.type = ini_token::section;
-            zed::trim(&dst.data);
+            dst.trim();
             m_stream.advance();
         }
         else
@@ -113,86 +206,200 @@ private:
             dst.type = ini_token::unexpected;
         }
     }
-    void parse_key(int ch, ini_token &dst)
+    void parse_key(int ch, Token &dst)
     {
-        do {
-            dst.data.push_back(ch);
-            ch = m_stream.advance();
-        } while (EOF != ch && '=' != ch && '\n' != ch);
-        if ('=' == ch)
+        take_first_and_until(ch, key_stops, dst);
+        if ('=' == m_stream.current_char())
         {
             dst.type = ini_token::key;
-            zed::trim_right(&dst.data);
+            dst.trim_right();
         }
     }
-    void parse_value(int ch, ini_token &dst)
+    void parse_value(int ch, Token &dst)
     {
-        do {
-            dst.data.push_back(ch);
-            ch = m_stream.advance();
-        } while (EOF != ch && '\n' != ch && ';' != ch);
+        if (EOF != ch)
+            take_first_and_until(ch, value_stops, dst);
         dst.type = ini_token::value;
-        zed::trim_right(&dst.data);
+        dst.trim_right();
     }
-    void parse_quoted_value(char q, ini_token &dst)
+    // The first char is taken even if it is a stop char.
+    void take_first_and_until(int first, const char_set &stop_chars, Token &dst)
     {
+        if (stop_chars.contains(static_cast<char>(first)))
+        {
+            dst.push_back(first);
+            m_stream.advance();
+        }
+        dst.append(m_stream.take_until(stop_chars));
+    }
+    void parse_quoted_value(char q, Token &dst)
+    {
+        const char_set &stop_chars = '"' == q ? double_quoted_stops : single_quoted_stops;
+
         int ch;
-        while ((ch = m_stream.advance()) != q)
+        m_stream.advance();
+        for (;;)
         {
+            dst.append(m_stream.take_until(stop_chars));
+
+            ch = m_stream.current_char();
+            if (q == ch)
+                break;
             if (EOF == ch || '\n' == ch)
                 return;
 
-            if ('\\' == ch)
+            ch = m_stream.advance();
+            if (EOF == ch)
+                return;
+
+            switch (ch)
             {
-                ch = m_stream.advance();
-                if (EOF == ch)
+                case 't': ch = '\t'; break;
+                case 'n': ch = '\n'; break;
+                case 'r': ch = '\r'; break;
+                case '\\': case '"': case '\'':
+                    break;
+                default:
+                    if ('\n' != ch)
+                        skip_line();
                     return;
-
-                switch (ch)
-                {
-                    case 't': ch = '\t'; break;
-                    case 'n': ch = '\n'; break;
-                    case 'r': ch = '\r'; break;
-                    case '\\': case '"': case '\'':
-                        break;
-                    default:
-                        if ('\n' != ch)
-                            skip_line();
-                        return;
-                }
             }
 
-            dst.data.push_back(ch);
+            dst.push_back(ch);
+            m_stream.advance();
         }
         m_stream.advance();
         dst.type = ini_token::value;
     }
     void skip_line(void)
     {
-        int ch;
-        do {
-            ch = m_stream.advance();
-        } while ('\n' != ch && EOF != ch);
+        m_stream.advance();
+        m_stream.skip_until(line_stops);
     }
 
-    parser_stream &m_stream;
+    static constexpr char_set blanks = char_set(" \t");
+    static constexpr char_set line_stops = char_set("\n");
+    static constexpr char_set section_stops = char_set("\n]");
+    static constexpr char_set key_stops = char_set("=\n");
+    static constexpr char_set value_stops = char_set("\n;");
+    static constexpr char_set double_quoted_stops = char_set("\"\\\n");
+    static constexpr char_set single_quoted_stops = char_set("'\\\n");
+
+    Stream &m_stream;
 };
 
-} // namespace detail
+// Parses the leading digits like `std::stoi`, but without exceptions.
+inline int ini_value_to_int(const string_piece<char> &v, int def)
+{
+    const char *p = v.data(), *end = v.data() + v.length();
+    if (p < end && '+' == *p && end - p > 1 && '-' != p[1])
+        ++p;
 
-inline int ini_data::get_int(const char *sec, const char *name, int def) const
+    int ret;
+    if (std::errc() == std::from_chars(p, end, ret).ec)
+        return ret;
+    return def;
+}
+
+inline void ini_span_token::append(const string_piece<char> &s)
 {
-    int ret = def;
-    if (const std::string *v = get_value(sec, name))
+    if (!m_materialized)
     {
-        try
+        if (m_span.empty())
         {
-            ret = std::stoi(*v);
+            m_span = s;
+            return;
         }
-        catch (...)
+        if (m_span.data() + m_span.length() == s.data())
+        {
+            m_span = string_piece<char>(m_span.data(), m_span.length() + s.length());
+            return;
+        }
+        materialize();
+    }
+    m_buffer.append(s.data(), s.length());
+}
+
+inline void ini_span_token::materialize(void)
+{
+    if (!m_materialized)
+    {
+        m_buffer.assign(m_span.data(), m_span.length());
+        m_materialized = true;
+    }
+}
+
+inline void ini_span_token::push_back(char ch)
+{
+    materialize();
+    m_buffer.push_back(ch);
+}
+
+inline void ini_span_token::trim(void)
+{
+    if (m_materialized)
+        zed::trim(&m_buffer);
+    else
+        m_span = zed::trim(m_span);
+}
+
+inline void ini_span_token::trim_right(void)
+{
+    if (m_materialized)
+        zed::trim_right(&m_buffer);
+    else
+        m_span = zed::trim_right(m_span);
+}
+
+} // namespace detail
+
+inline int ini_data::get_int(const char *sec, const char *name, int def) const
+{
+    const std::string *v = get_value(sec, name);
+    return nullptr != v ? detail::ini_value_to_int(string_piece<char>(*v), def) : def;
+}
+
+inline frozen_ini_data ini_data::freeze(void) const
+{
+    frozen_ini_data ret;
+
+    std::vector<std::uint64_t> hashes;
+    for (const auto &[sec_name, sec] : m_sections)
+    {
+        auto section = static_cast<std::uint32_t>(ret.m_chars.length());
+        ret.m_chars.append(sec_name.data(), sec_name.length());
+        for (const auto &[name, value] : sec)
         {
+            frozen_ini_data::entry e;
+            e.section = section;
+            e.section_length = static_cast<std::uint32_t>(sec_name.length());
+            e.name = static_cast<std::uint32_t>(ret.m_chars.length());
+            e.name_length = static_cast<std::uint32_t>(name.length());
+            ret.m_chars.append(name.data(), name.length());
+            e.value = static_cast<std::uint32_t>(ret.m_chars.length());
+            e.value_length = static_cast<std::uint32_t>(value.length());
+            ret.m_chars.append(value);
+            ret.m_entries.push_back(e);
         }
     }
+    ZASSERT(ret.m_chars.length() <= UINT32_MAX);
+
+    // Some seeds may leave a bucket without any displacement, which is unlikely, but possible.
+    std::vector<std::uint32_t> slots;
+    do {
+        ++ret.m_seed;
+        hashes.clear();
+        for (const frozen_ini_data::entry &e : ret.m_entries)
+            hashes.push_back(frozen_ini_data::hash(ret.chars(e.section, e.section_length), ret.chars(e.name, e.name_length), ret.m_seed));
+    } while (!ret.build(hashes, slots));
+
+    std::vector<frozen_ini_data::entry> entries(ret.m_entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        entries[slots[i]] = ret.m_entries[i];
+        entries[slots[i]].fingerprint = static_cast<std::uint32_t>(hashes[i] >> 32);
+    }
+    ret.m_entries.swap(entries);
     return ret;
 }
 
@@ -223,22 +430,34 @@ inline const std::string* ini_data::get_value(const char *sec, const char *name)
 template <class String>
 ini_data ini_data::parse_string(const String &s)
 {
-    parser_string_stream stream(s);
+    basic_parser_stream<parser_string_source> stream(s);
     return parse_stream(stream);
 }
 
 inline ini_data ini_data::parse_cstr(const char *psz)
 {
-    parser_psz_stream stream(psz);
+    basic_parser_stream<parser_psz_source> stream(psz);
     return parse_stream(stream);
 }
 
 inline ini_data ini_data::parse_stream(parser_stream &stream)
+{
+    return parse(stream);
+}
+
+template <class Source>
+ini_data ini_data::parse_stream(basic_parser_stream<Source> &stream)
+{
+    return parse(stream);
+}
+
+template <class Stream>
+ini_data ini_data::parse(Stream &stream)
 {
     ini_data ret;
     using namespace detail;
 
-    ini_tokenizer tokenizer(stream);
+    ini_tokenizer<Stream> tokenizer(stream);
     ini_token t(ini_token::unexpected);
     ini_data::section *cur_sec = nullptr;
     do {
@@ -250,7 +469,7 @@ inline ini_data ini_data::parse_stream(parser_stream &stream)
                 stream.advance();
                 ini_token v = tokenizer.get_value();
                 if (ini_token::value == v.type && nullptr != cur_sec)
-                    cur_sec->emplace(t.data, v.data);
+                    cur_sec->emplace(t.data, std::move(v.data));
                 break;
             }
             case ini_token::section:
@@ -264,6 +483,139 @@ inline ini_data ini_data::parse_stream(parser_stream &stream)
     return ret;
 }
 
+inline bool frozen_ini_data::build(const std::vector<std::uint64_t> &hashes, std::vector<std::uint32_t> &slots)
+{
+    constexpr std::uint32_t max_displacement = 1 << 20;
+
+    size_t n = hashes.size();
+    ZASSERT(n < direct_slot);
+    m_displacements.assign((n + 1) / 2, 0);
+    size_t bucket_count = m_displacements.size();
+
+    // Keys are grouped by buckets with a counting sort.
+    std::vector<std::uint32_t> bucket_of(n), starts(bucket_count + 1, 0), keys_by_bucket(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bucket_of[i] = static_cast<std::uint32_t>(reduce(hashes[i] >> 32, bucket_count));
+        ++starts[bucket_of[i] + 1];
+    }
+    for (size_t b = 0; b < bucket_count; ++b)
+        starts[b + 1] += starts[b];
+    std::vector<std::uint32_t> fill(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+        keys_by_bucket[fill[bucket_of[i]]++] = static_cast<std::uint32_t>(i);
+
+    // Buckets are placed from the largest, while there are still many free slots.
+    std::vector<std::uint32_t> order(bucket_count);
+    for (size_t b = 0; b < bucket_count; ++b)
+        order[b] = static_cast<std::uint32_t>(b);
+    std::stable_sort(order.begin(), order.end(), [&starts](std::uint32_t a, std::uint32_t b) {
+        return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+    });
+
+    slots.assign(n, 0);
+    std::vector<bool> taken(n, false);
+    size_t free_slot = 0;
+    for (std::uint32_t b : order)
+    {
+        const std::uint32_t *keys = keys_by_bucket.data() + starts[b];
+        size_t count = starts[b + 1] - starts[b];
+        if (count < 2)
+        {
+            if (0 == count)
+                break;
+            while (taken[free_slot])
+                ++free_slot;
+            taken[free_slot] = true;
+            slots[keys[0]] = static_cast<std::uint32_t>(free_slot);
+            m_displacements[b] = direct_slot | static_cast<std::uint32_t>(free_slot);
+            continue;
+        }
+
+        std::uint32_t d = 0;
+        for (;; ++d)
+        {
+            if (max_displacement == d)
+                return false;
+
+            size_t placed = 0;
+            for (; placed < count; ++placed)
+            {
+                size_t slot = slot_of(hashes[keys[placed]], d, n);
+                if (taken[slot])
+                    break;
+                taken[slot] = true;
+                slots[keys[placed]] = static_cast<std::uint32_t>(slot);
+            }
+            if (count == placed)
+                break;
+
+            // Frees the slots taken by this try.
+            for (size_t i = 0; i < placed; ++i)
+                taken[slots[keys[i]]] = false;
+        }
+        m_displacements[b] = d;
+    }
+    return true;
+}
+
+inline const frozen_ini_data::entry* frozen_ini_data::find(const string_piece<char> &sec, const string_piece<char> &name) const
+{
+    if (m_entries.empty())
+        return nullptr;
+
+    std::uint64_t h = hash(sec, name, m_seed);
+    std::uint32_t d = m_displacements[reduce(h >> 32, m_displacements.size())];
+    const entry &e = m_entries[0 != (d & direct_slot) ? d & ~direct_slot : slot_of(h, d, m_entries.size())];
+    if (static_cast<std::uint32_t>(h >> 32) != e.fingerprint)
+        return nullptr;
+
+    string_piece<char> s = chars(e.section, e.section_length), n = chars(e.name, e.name_length);
+    if (s.length() != sec.length() || n.length() != name.length())
+        return nullptr;
+    if (0 != std::memcmp(s.data(), sec.data(), s.length()) || 0 != std::memcmp(n.data(), name.data(), n.length()))
+        return nullptr;
+    return &e;
+}
+
+inline int frozen_ini_data::get_int(const string_piece<char> &sec, const string_piece<char> &name, int def) const
+{
+    const entry *e = find(sec, name);
+    return nullptr != e ? detail::ini_value_to_int(chars(e->value, e->value_length), def) : def;
+}
+
+inline string_piece<char> frozen_ini_data::get_string(const string_piece<char> &sec, const string_piece<char> &name, const string_piece<char> &def) const
+{
+    const entry *e = find(sec, name);
+    return nullptr != e ? chars(e->value, e->value_length) : def;
+}
+
+inline std::uint64_t frozen_ini_data::hash(const string_piece<char> &sec, const string_piece<char> &name, std::uint64_t seed)
+{
+    // FNV-1a, with a separator which cannot be in names.
+    std::uint64_t ret = 14695981039346656037ull ^ seed;
+    for (size_t i = 0; i < sec.length(); ++i)
+        ret = (ret ^ static_cast<unsigned char>(sec.data()[i])) * 1099511628211ull;
+    ret = (ret ^ '\n') * 1099511628211ull;
+    for (size_t i = 0; i < name.length(); ++i)
+        ret = (ret ^ static_cast<unsigned char>(name.data()[i])) * 1099511628211ull;
+
+    // FNV leaves the high bits poorly mixed.
+    ret ^= ret >> 33;
+    ret *= 0xff51afd7ed558ccdull;
+    ret ^= ret >> 33;
+    return ret;
+}
+
+inline size_t frozen_ini_data::slot_of(std::uint64_t h, std::uint32_t displacement, size_t n)
+{
+    std::uint64_t x = h ^ (displacement * 0x9e3779b97f4a7c15ull);
+    x ^= x >> 29;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 32;
+    return reduce(x, n);
+}
+
 } // namespace zed
 
 #endif // ZED_PARSERS_INI_HPP
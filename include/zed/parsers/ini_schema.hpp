@@ -0,0 +1,265 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: ini_schema.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_PARSERS_INI_SCHEMA_HPP
+#define ZED_PARSERS_INI_SCHEMA_HPP
+
+#include <charconv>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "../string.hpp"
+#include "./ini.hpp"
+
+namespace zed {
+
+/**
+ * INI Schemas
+ *
+ * Bind members of a config struct to (section, name) pairs once, then read the struct on hot
+ * paths instead of looking values up:
+ *
+ *   ini_schema<server_config> schema;
+ *   schema.bind("server", "port", &server_config::port, 8080, 1, 65535)
+ *         .bind("server", "host", &server_config::host, "localhost");
+ *
+ *   ini_bind_report report;
+ *   server_config config;
+ *   schema.apply(data, config, &report);
+ *
+ * Values are converted with `std::from_chars`, no exceptions and no locales involved. Members of
+ * missing keys get their defaults, so do members of malformed or out-of-range values, which are
+ * reported as well.
+ *
+ * Supported member types: integers, floating-point numbers, bool ("true"/"false", "yes"/"no",
+ * "on"/"off", "1"/"0", in any case) and std::string.
+ */
+
+struct ini_bind_error
+{
+    enum error_type { malformed, out_of_range };
+
+    error_type type;
+    std::string section, name, value;
+};
+
+struct ini_bind_report
+{
+    std::vector<ini_bind_error> errors;
+
+    bool ok(void) const { return errors.empty(); }
+};
+
+template <class T>
+class ini_schema
+{
+public:
+    template <typename V, typename D>
+    ini_schema& bind(const char *sec, const char *name, V T::*member, const D &def);
+    // Values out of [min, max] are reported as `out_of_range`.
+    template <typename V, typename D>
+    ini_schema& bind(const char *sec, const char *name, V T::*member, const D &def, typename std::common_type<V>::type min, typename std::common_type<V>::type max);
+
+    // Returns false if any error is reported.
+    bool apply(const ini_data &data, T &dst, ini_bind_report *report = nullptr) const;
+    bool apply(const frozen_ini_data &data, T &dst, ini_bind_report *report = nullptr) const;
+private:
+    class field;
+    template <typename V>
+    class typed_field;
+
+    template <class Lookup>
+    bool apply_with(const Lookup &lookup, T &dst, ini_bind_report *report) const;
+
+    std::vector<std::unique_ptr<field>> m_fields;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+template <typename V>
+std::errc parse_ini_value(const string_piece<char> &s, V &dst)
+{
+    if constexpr (std::is_same<V, bool>::value)
+    {
+        static const char *true_values[] = { "true", "yes", "on", "1" };
+        static const char *false_values[] = { "false", "no", "off", "0" };
+        for (const char *v : true_values)
+        {
+            if (0 == zed::stricmp(s, v))
+                return dst = true, std::errc();
+        }
+        for (const char *v : false_values)
+        {
+            if (0 == zed::stricmp(s, v))
+                return dst = false, std::errc();
+        }
+        return std::errc::invalid_argument;
+    }
+    else
+    {
+        const char *p = s.data(), *end = s.data() + s.length();
+        if (p < end && '+' == *p)
+            ++p;
+
+        std::from_chars_result r = std::from_chars(p, end, dst);
+        if (std::errc() == r.ec && end != r.ptr)
+            return std::errc::invalid_argument; // Trailing garbage.
+        return r.ec;
+    }
+}
+
+inline std::errc parse_ini_value(const string_piece<char> &s, std::string &dst)
+{
+    dst.assign(s.data(), s.length());
+    return std::errc();
+}
+
+} // namespace detail
+
+template <class T>
+class ini_schema<T>::field
+{
+public:
+    field(const char *sec, const char *name) : m_section(sec), m_name(name) {}
+    virtual ~field(void) = default;
+
+    const std::string& section(void) const { return m_section; }
+    const std::string& name(void) const { return m_name; }
+
+    virtual void set_default(T &dst) const = 0;
+    // Returns false and leaves `dst` unchanged on errors.
+    virtual bool set(T &dst, const string_piece<char> &value, ini_bind_error::error_type &error) const = 0;
+private:
+    const std::string m_section, m_name;
+};
+
+template <class T>
+template <typename V>
+class ini_schema<T>::typed_field final : public field
+{
+public:
+    typed_field(const char *sec, const char *name, V T::*member, V def) : field(sec, name), m_member(member), m_default(std::move(def)) {}
+    typed_field(const char *sec, const char *name, V T::*member, V def, V min, V max)
+        : field(sec, name), m_member(member), m_default(std::move(def)), m_min(min), m_max(max), m_ranged(true)
+    {
+    }
+
+    void set_default(T &dst) const override { dst.*m_member = m_default; }
+    bool set(T &dst, const string_piece<char> &value, ini_bind_error::error_type &error) const override;
+private:
+    V T::*m_member;
+    V m_default;
+    V m_min = V(), m_max = V();
+    bool m_ranged = false;
+};
+
+template <class T>
+template <typename V, typename D>
+ini_schema<T>& ini_schema<T>::bind(const char *sec, const char *name, V T::*member, const D &def)
+{
+    m_fields.push_back(std::make_unique<typed_field<V>>(sec, name, member, V(def)));
+    return *this;
+}
+
+template <class T>
+template <typename V, typename D>
+ini_schema<T>& ini_schema<T>::bind(const char *sec, const char *name, V T::*member, const D &def, typename std::common_type<V>::type min, typename std::common_type<V>::type max)
+{
+    static_assert(std::is_arithmetic<V>::value, "Only numbers can have ranges!");
+    ZASSERT(min <= max);
+    m_fields.push_back(std::make_unique<typed_field<V>>(sec, name, member, V(def), min, max));
+    return *this;
+}
+
+template <class T>
+bool ini_schema<T>::apply(const ini_data &data, T &dst, ini_bind_report *report) const
+{
+    return apply_with([&data](const field &f, string_piece<char> &value) {
+        const ini_data::section *sec = data.get_section(f.section().c_str());
+        if (nullptr == sec)
+            return false;
+
+        auto it = sec->find(f.name());
+        if (sec->end() == it)
+            return false;
+        value = string_piece<char>(it->second);
+        return true;
+    }, dst, report);
+}
+
+template <class T>
+bool ini_schema<T>::apply(const frozen_ini_data &data, T &dst, ini_bind_report *report) const
+{
+    return apply_with([&data](const field &f, string_piece<char> &value) {
+        string_piece<char> sec(f.section()), name(f.name());
+        if (!data.contains(sec, name))
+            return false;
+        value = data.get_string(sec, name);
+        return true;
+    }, dst, report);
+}
+
+template <class T>
+template <class Lookup>
+bool ini_schema<T>::apply_with(const Lookup &lookup, T &dst, ini_bind_report *report) const
+{
+    bool ret = true;
+    for (const std::unique_ptr<field> &f : m_fields)
+    {
+        string_piece<char> value;
+        if (!lookup(*f, value))
+        {
+            f->set_default(dst);
+            continue;
+        }
+
+        ini_bind_error::error_type error;
+        if (f->set(dst, value, error))
+            continue;
+
+        f->set_default(dst);
+        ret = false;
+        if (nullptr != report)
+            report->errors.push_back({ error, f->section(), f->name(), std::string(value.data(), value.length()) });
+    }
+    return ret;
+}
+
+template <class T>
+template <typename V>
+bool ini_schema<T>::typed_field<V>::set(T &dst, const string_piece<char> &value, ini_bind_error::error_type &error) const
+{
+    V v;
+    std::errc r = detail::parse_ini_value(value, v);
+    if (std::errc() != r)
+    {
+        error = std::errc::result_out_of_range == r ? ini_bind_error::out_of_range : ini_bind_error::malformed;
+        return false;
+    }
+
+    if constexpr (std::is_arithmetic<V>::value)
+    {
+        if (m_ranged && (v < m_min || m_max < v))
+        {
+            error = ini_bind_error::out_of_range;
+            return false;
+        }
+    }
+    dst.*m_member = std::move(v);
+    return true;
+}
+
+} // namespace zed
+
+#endif // ZED_PARSERS_INI_SCHEMA_HPP
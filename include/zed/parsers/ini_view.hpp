@@ -0,0 +1,279 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: ini_view.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_PARSERS_INI_VIEW_HPP
+#define ZED_PARSERS_INI_VIEW_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "../file/mapped_file.hpp"
+#include "../string/builder.hpp"
+#include "./ini.hpp"
+
+namespace zed {
+
+/**
+ * INI Views
+ *
+ * Read-only `ini_data` over a memory-mapped file, for large files. Names and values are pieces of
+ * the mapping, only values with escapes are copied, so parsing allocates little more than one
+ * entry per key. Each section indexes its keys in its own hash table, which stays in cache while
+ * the section is parsed. The same rules as `ini_data` apply: the first value of a key wins, and
+ * keys out of sections are ignored.
+ */
+
+namespace detail {
+
+// Open-addressing hash table of indices, which are compared by callers.
+class ini_view_index
+{
+public:
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+    template <typename Equals>
+    std::uint32_t find(std::uint32_t h, const Equals &equals) const;
+    // Returns the index equal to `index`, which is inserted if there is none.
+    template <typename Equals>
+    std::uint32_t emplace(std::uint32_t h, std::uint32_t index, const Equals &equals);
+private:
+    struct slot {
+        std::uint32_t index, hash;
+    };
+
+    template <typename Equals>
+    size_t find_slot(std::uint32_t h, const Equals &equals) const;
+    void grow(void);
+
+    std::vector<slot> m_slots;
+    size_t m_count = 0;
+};
+
+} // namespace detail
+
+class ini_view
+{
+public:
+    ini_view(void) = default;
+    ~ini_view(void) { close(); }
+
+    ini_view(const ini_view &) = delete;
+    ini_view& operator=(const ini_view &) = delete;
+
+    bool open(file::path_t path);
+    void close(void);
+
+    int get_int(const char *sec, const char *name, int def) const;
+    // Pieces are valid until the view is closed.
+    string_piece<char> get_string(const char *sec, const char *name, const char *def = "") const;
+
+    size_t size(void) const { return m_entries.size(); }
+private:
+    struct entry {
+        string_piece<char> name, value;
+    };
+    struct section {
+        string_piece<char> name;
+        detail::ini_view_index keys;
+    };
+    static std::uint32_t hash(const string_piece<char> &s);
+    static bool equals(const string_piece<char> &a, const string_piece<char> &b);
+
+    void parse(void);
+    string_piece<char> keep(const detail::ini_span_token &t);
+    const entry* find(const string_piece<char> &sec, const string_piece<char> &name) const;
+
+    mapped_file m_file;
+    std::vector<section> m_sections;
+    detail::ini_view_index m_section_index;
+    std::vector<entry> m_entries;
+    string_builder m_materialized;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+template <typename Equals>
+std::uint32_t ini_view_index::emplace(std::uint32_t h, std::uint32_t index, const Equals &equals)
+{
+    // Kept at most half full.
+    if (2 * (m_count + 1) > m_slots.size())
+        grow();
+
+    slot &s = m_slots[find_slot(h, equals)];
+    if (npos != s.index)
+        return s.index;
+    s.index = index;
+    s.hash = h;
+    ++m_count;
+    return index;
+}
+
+template <typename Equals>
+std::uint32_t ini_view_index::find(std::uint32_t h, const Equals &equals) const
+{
+    return m_slots.empty() ? npos : m_slots[find_slot(h, equals)].index;
+}
+
+template <typename Equals>
+size_t ini_view_index::find_slot(std::uint32_t h, const Equals &equals) const
+{
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask)
+    {
+        const slot &s = m_slots[i];
+        if (npos == s.index || (h == s.hash && equals(s.index)))
+            return i;
+    }
+}
+
+inline void ini_view_index::grow(void)
+{
+    std::vector<slot> old(std::max<size_t>(m_slots.size() * 2, 8), slot{ npos, 0 });
+    m_slots.swap(old);
+
+    size_t mask = m_slots.size() - 1;
+    for (const slot &s : old)
+    {
+        if (npos == s.index)
+            continue;
+        size_t i = s.hash & mask;
+        while (npos != m_slots[i].index)
+            i = (i + 1) & mask;
+        m_slots[i] = s;
+    }
+}
+
+} // namespace detail
+
+inline void ini_view::close(void)
+{
+    m_file.close();
+    m_sections.clear();
+    m_section_index = detail::ini_view_index();
+    m_entries.clear();
+    m_materialized.clear();
+}
+
+inline bool ini_view::equals(const string_piece<char> &a, const string_piece<char> &b)
+{
+    return a.length() == b.length() && 0 == std::memcmp(a.data(), b.data(), a.length());
+}
+
+inline const ini_view::entry* ini_view::find(const string_piece<char> &sec, const string_piece<char> &name) const
+{
+    std::uint32_t i = m_section_index.find(hash(sec), [this, &sec](std::uint32_t index) {
+        return equals(sec, m_sections[index].name);
+    });
+    if (detail::ini_view_index::npos == i)
+        return nullptr;
+
+    i = m_sections[i].keys.find(hash(name), [this, &name](std::uint32_t index) {
+        return equals(name, m_entries[index].name);
+    });
+    return detail::ini_view_index::npos != i ? &m_entries[i] : nullptr;
+}
+
+inline int ini_view::get_int(const char *sec, const char *name, int def) const
+{
+    return detail::ini_value_to_int(get_string(sec, name), def);
+}
+
+inline string_piece<char> ini_view::get_string(const char *sec, const char *name, const char *def) const
+{
+    string_piece<char> s(sec, std::strlen(sec)), n(name, std::strlen(name));
+    if (const entry *e = find(s, n))
+        return e->value;
+    return string_piece<char>(def, std::strlen(def));
+}
+
+inline std::uint32_t ini_view::hash(const string_piece<char> &s)
+{
+    // FNV-1a
+    std::uint32_t ret = 2166136261u;
+    for (size_t i = 0; i < s.length(); ++i)
+        ret = (ret ^ static_cast<unsigned char>(s.data()[i])) * 16777619u;
+    return ret;
+}
+
+inline string_piece<char> ini_view::keep(const detail::ini_span_token &t)
+{
+    string_piece<char> s = t.data();
+    if (!t.materialized() || s.empty())
+        return s;
+
+    char *p = m_materialized.prepare(s.length());
+    std::memcpy(p, s.data(), s.length());
+    m_materialized.commit(s.length());
+    return string_piece<char>(p, s.length());
+}
+
+inline bool ini_view::open(file::path_t path)
+{
+    close();
+    if (!m_file.open(path, mapped_file::read_only, mapped_file::sequential))
+        return false;
+
+    parse();
+    return true;
+}
+
+inline void ini_view::parse(void)
+{
+    using namespace detail;
+
+    using stream_t = basic_parser_stream<parser_string_source>;
+    stream_t stream(m_file.view());
+    ini_tokenizer<stream_t, ini_span_token> tokenizer(stream);
+
+    ini_span_token t;
+    std::uint32_t cur_sec = ini_view_index::npos;
+    do {
+        t = tokenizer.get();
+        switch (t.type)
+        {
+            case ini_token::key:
+            {
+                stream.advance();
+                ini_span_token v = tokenizer.get_value();
+                if (ini_token::value != v.type || ini_view_index::npos == cur_sec)
+                    break;
+
+                string_piece<char> name = keep(t);
+                std::uint32_t i = static_cast<std::uint32_t>(m_entries.size());
+                std::uint32_t j = m_sections[cur_sec].keys.emplace(hash(name), i, [this, &name](std::uint32_t index) {
+                    return equals(name, m_entries[index].name);
+                });
+                if (i == j)
+                    m_entries.push_back({ name, keep(v) });
+                break;
+            }
+            case ini_token::section:
+            {
+                string_piece<char> name = keep(t);
+                std::uint32_t i = static_cast<std::uint32_t>(m_sections.size());
+                cur_sec = m_section_index.emplace(hash(name), i, [this, &name](std::uint32_t index) {
+                    return equals(name, m_sections[index].name);
+                });
+                if (i == cur_sec)
+                    m_sections.push_back({ name, ini_view_index() });
+                break;
+            }
+        }
+    } while (!t.is_finished());
+    m_entries.shrink_to_fit();
+}
+
+} // namespace zed
+
+#endif // ZED_PARSERS_INI_VIEW_HPP
@@ -0,0 +1,76 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: simd.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_SIMD_HPP
+#define ZED_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "./assert.h"
+#include "./build_macros.h"
+#if defined(_Z_SIMD_AVX2)
+#   include <immintrin.h>
+#elif defined(_Z_SIMD_SSSE3)
+#   include <tmmintrin.h>
+#elif defined(_Z_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
+
+namespace zed {
+namespace detail {
+
+/**
+ * NOTE:
+ *
+ *   Kernels reading NUL-terminated strings may load bytes beyond the terminator,
+ *   but such loads never cross a page boundary, so they never fault. Such kernels
+ *   are marked `ZED_NO_SANITIZE_ADDRESS`, as AddressSanitizer reports them anyway.
+ */
+
+constexpr std::size_t page_size = 4096;
+
+template <std::size_t Width>
+inline bool load_is_page_safe(const void *p)
+{
+    return (reinterpret_cast<std::uintptr_t>(p) & (page_size - 1)) <= page_size - Width;
+}
+
+inline unsigned count_trailing_zeros(std::uint32_t mask)
+{
+    ZASSERT(0 != mask);
+#ifdef _MSC_VER
+    unsigned long ret;
+    _BitScanForward(&ret, mask);
+    return ret;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline unsigned highest_bit_index(std::uint32_t mask)
+{
+    ZASSERT(0 != mask);
+#ifdef _MSC_VER
+    unsigned long ret;
+    _BitScanReverse(&ret, mask);
+    return ret;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+} // namespace detail
+} // namespace zed
+
+#endif // ZED_SIMD_HPP
@@ -14,9 +14,12 @@
 
 #include "./build_macros.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include "./assert.h"
 #include "./ctype.hpp"
+#include "./simd.hpp"
 #include "./type_traits.hpp"
 #ifdef _Z_STRING_VIEW_ENABLED
 #   include <string_view>
@@ -72,10 +75,34 @@ template <typename S1, typename S2, typename = std::enable_if<chartypes_same<S1,
 int stricmp(const S1 &s1, const S2 &s2);
 
 template <typename S1, typename S2, typename = std::enable_if<chartypes_same<S1, S2>::value>>
-bool strequ(const S1 &s1, const S2 &s2) { return 0 == zed::strcmp(s1, s2); }
+bool strequ(const S1 &s1, const S2 &s2);
 
 template <typename S1, typename S2, typename = std::enable_if<chartypes_same<S1, S2>::value>>
-bool striequ(const S1 &s1, const S2 &s2) { return 0 == zed::stricmp(s1, s2); }
+bool striequ(const S1 &s1, const S2 &s2);
+
+/**
+ * Searching
+ *
+ * Results are positions like `std::basic_string_view::find` returns, `npos` if nothing found.
+ * Narrow strings are scanned by SIMD kernels.
+ */
+
+template <typename CharT>
+size_t find_char(const string_piece<CharT> &s, CharT ch, size_t pos = 0);
+
+template <typename CharT>
+size_t find_string(const string_piece<CharT> &s, const string_piece<CharT> &pattern, size_t pos = 0);
+
+template <typename CharT>
+size_t find_first_of(const string_piece<CharT> &s, const string_piece<CharT> &chars, size_t pos = 0);
+template <typename CharT>
+size_t find_first_of(const string_piece<CharT> &s, const char_set &set, size_t pos = 0);
+
+template <typename CharT>
+size_t find_first_not_of(const string_piece<CharT> &s, const char_set &set, size_t pos = 0);
+
+template <typename CharT>
+size_t find_last_not_of(const string_piece<CharT> &s, const char_set &set);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementations
@@ -93,7 +120,9 @@ public:
 
     size_t find(const char_type *psz, size_t pos = 0) const { return m_s.find(psz, pos); }
     size_t find_first_not_of(const char_type *psz) const { return m_s.find_first_not_of(psz); }
+    size_t find_first_not_of(const char_set &set) const { return zed::find_first_not_of(piece(), set); }
     size_t find_last_not_of(const char_type *psz) const { return m_s.find_last_not_of(psz); }
+    size_t find_last_not_of(const char_set &set) const { return zed::find_last_not_of(piece(), set); }
 
     string_piece<char_type> sub_piece(size_t pos, size_t count = npos) const
     {
@@ -101,6 +130,8 @@ public:
         return count > 0 ? string_piece<char_type>(m_s.data() + pos, count) : string_piece<char_type>();
     }
 private:
+    string_piece<char_type> piece(void) const { return string_piece<char_type>(m_s.data(), m_s.length()); }
+
     const T &m_s;
 };
 
@@ -113,6 +144,10 @@ public:
 
     explicit string_adaptor(const CharT *psz) : m_psz(psz) {}
 
+    size_t find(const char_type *psz, size_t pos = 0) const
+    {
+        return zed::find_string(string_piece<CharT>(m_psz), string_piece<CharT>(psz), pos);
+    }
     size_t find_first_not_of(const char_type *psz) const
     {
         for (const CharT *p = m_psz; '\0' != *p; ++p)
@@ -122,9 +157,18 @@ public:
         }
         return npos;
     }
+    size_t find_first_not_of(const char_set &set) const
+    {
+        for (const CharT *p = m_psz; '\0' != *p; ++p)
+        {
+            if (!set.contains(*p))
+                return p - m_psz;
+        }
+        return npos;
+    }
     size_t find_last_not_of(const char_type *psz) const
     {
-        size_t i = 0, ret = 0;
+        size_t i = 0, ret = npos;
         for (const CharT *p = m_psz; '\0' != *p; ++p)
         {
             if (!in_chars(psz, *p))
@@ -133,6 +177,10 @@ public:
         }
         return ret;
     }
+    size_t find_last_not_of(const char_set &set) const
+    {
+        return zed::find_last_not_of(string_piece<CharT>(m_psz), set);
+    }
 
     string_piece<char_type> sub_piece(size_t pos, size_t count = npos) const
     {
@@ -270,6 +318,658 @@ private:
     const char_type *m_psz;
 };
 
+/**
+ * Contiguous Access
+ *
+ * Strings with known lengths are compared by length first and then by blocks,
+ * NUL-terminated ones are scanned in blocks without knowing their lengths.
+ */
+
+template <typename T>
+struct string_traits
+{
+    using char_type = typename T::value_type;
+    static constexpr bool is_psz = false;
+
+    static string_piece<char_type> piece(const T &s) { return string_piece<char_type>(s.data(), s.length()); }
+};
+
+template <typename CharT>
+struct string_traits<const CharT *>
+{
+    using char_type = CharT;
+    static constexpr bool is_psz = true;
+
+    static const CharT* psz(const CharT *s) { return s; }
+    static string_piece<char_type> piece(const CharT *s) { return string_piece<char_type>(s, std::char_traits<CharT>::length(s)); }
+};
+
+template <typename CharT>
+struct string_traits<CharT *> : string_traits<const CharT *> {};
+
+template <typename CharT, size_t N>
+struct string_traits<CharT[N]>
+{
+    using char_type = std::remove_const_t<CharT>;
+    static constexpr bool is_psz = false;
+
+    static string_piece<char_type> piece(const CharT (&s)[N])
+    {
+        const char_type *end = std::char_traits<char_type>::find(s, N, char_type());
+        return string_piece<char_type>(s, nullptr != end ? end - s : N);
+    }
+};
+
+template <typename CharT>
+int compare_chars(CharT c1, CharT c2)
+{
+    if (c1 > c2)
+        return 1;
+    if (c1 < c2)
+        return -1;
+    return 0;
+}
+
+template <typename CharT>
+int compare_psz_chars(CharT c1, CharT c2)
+{
+    // Terminators are ends of strings, not chars.
+    if ('\0' == c1)
+        return '\0' == c2 ? 0 : -1;
+    if ('\0' == c2)
+        return 1;
+    return compare_chars(c1, c2);
+}
+
+template <typename CharT>
+size_t mismatch(const CharT *p1, const CharT *p2, size_t length)
+{
+    // Compares bytes, the first different byte always lies in the first different char.
+    const unsigned char *b1 = reinterpret_cast<const unsigned char *>(p1);
+    const unsigned char *b2 = reinterpret_cast<const unsigned char *>(p2);
+    size_t i = 0, n = length * sizeof(CharT);
+#ifdef _Z_SIMD_AVX2
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b1 + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b2 + i));
+        std::uint32_t mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        if (0 != mask)
+            return (i + count_trailing_zeros(mask)) / sizeof(CharT);
+    }
+#endif
+#ifdef _Z_SIMD_SSE2
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b1 + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b2 + i));
+        std::uint32_t mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xffff;
+        if (0 != mask)
+            return (i + count_trailing_zeros(mask)) / sizeof(CharT);
+    }
+#endif
+    for (i /= sizeof(CharT); i < length; ++i)
+    {
+        if (p1[i] != p2[i])
+            return i;
+    }
+    return length;
+}
+
+template <typename CharT>
+int compare_pieces(const string_piece<CharT> &s1, const string_piece<CharT> &s2)
+{
+    size_t n = std::min(s1.length(), s2.length());
+    size_t i = mismatch(s1.data(), s2.data(), n);
+    if (i < n)
+        return compare_chars(s1[i], s2[i]);
+    return compare_chars(s1.length(), s2.length());
+}
+
+template <typename CharT>
+int compare_pszs(const CharT *p1, const CharT *p2)
+{
+    for (;; ++p1, ++p2)
+    {
+        if (*p1 != *p2 || '\0' == *p1)
+            return compare_psz_chars(*p1, *p2);
+    }
+}
+
+#ifdef _Z_SIMD_SSE2
+template <>
+ZED_NO_SANITIZE_ADDRESS inline int compare_pszs<char>(const char *p1, const char *p2)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (;;)
+    {
+        if (!load_is_page_safe<16>(p1) || !load_is_page_safe<16>(p2))
+        {
+            if (*p1 != *p2 || '\0' == *p1)
+                return compare_psz_chars(*p1, *p2);
+            ++p1; ++p2;
+            continue;
+        }
+
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p2));
+        std::uint32_t diff = ~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xffff;
+        std::uint32_t terminated = _mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+        if (std::uint32_t mask = diff | terminated)
+        {
+            unsigned i = count_trailing_zeros(mask);
+            return compare_psz_chars(p1[i], p2[i]);
+        }
+        p1 += 16; p2 += 16;
+    }
+}
+#endif
+
+/**
+ * Case-insensitive Stuff
+ *
+ * Chars are folded by `fold_ascii_case`, and the first folded mismatch decides the order:
+ * two letters are compared in lower case, otherwise the original chars are compared.
+ */
+
+template <typename CharT>
+int compare_chars_ignoring_case(CharT c1, CharT c2)
+{
+    if (zed::isalpha(c1) && zed::isalpha(c2))
+        return compare_chars(fold_ascii_case(c1), fold_ascii_case(c2));
+    return compare_chars(c1, c2);
+}
+
+template <typename CharT>
+int compare_psz_chars_ignoring_case(CharT c1, CharT c2)
+{
+    if ('\0' == c1)
+        return '\0' == c2 ? 0 : -1;
+    if ('\0' == c2)
+        return 1;
+    return compare_chars_ignoring_case(c1, c2);
+}
+
+#ifdef _Z_SIMD_SSE2
+// Toggles the case of letters in [first, first + 26), the letters of the other case are kept.
+inline __m128i toggle_ascii_case(__m128i v, char first)
+{
+    // Signed compares only: shift the letters to the bottom of the signed range first.
+    __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+    __m128i letters = _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + 26)));
+    return _mm_xor_si128(v, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+
+inline __m128i fold_ascii_case(__m128i v)
+{
+    return toggle_ascii_case(v, 'A');
+}
+#endif
+
+#ifdef _Z_SIMD_AVX2
+inline __m256i toggle_ascii_case(__m256i v, char first)
+{
+    __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+    __m256i letters = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 26)), shifted);
+    return _mm256_xor_si256(v, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+
+inline __m256i fold_ascii_case(__m256i v)
+{
+    return toggle_ascii_case(v, 'A');
+}
+#endif
+
+// `dst` may be the same as `src`.
+template <bool Upper, typename CharT>
+void convert_ascii_case(CharT *dst, const CharT *src, size_t length)
+{
+    const detail::ascii_case_table &table = Upper ? ascii_upper : ascii_fold;
+
+    size_t i = 0;
+    if constexpr (1 == sizeof(CharT))
+    {
+        const char first = Upper ? 'a' : 'A';
+#ifdef _Z_SIMD_AVX2
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), toggle_ascii_case(v, first));
+        }
+#endif
+#ifdef _Z_SIMD_SSE2
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), toggle_ascii_case(v, first));
+        }
+#endif
+        for (; i < length; ++i)
+            dst[i] = static_cast<CharT>(table.values[static_cast<unsigned char>(src[i])]);
+    }
+    else
+    {
+        for (; i < length; ++i)
+            dst[i] = 0 <= src[i] && src[i] < 0x80 ? static_cast<CharT>(table.values[src[i]]) : src[i];
+    }
+}
+
+template <typename CharT>
+size_t mismatch_ignoring_case(const CharT *p1, const CharT *p2, size_t length)
+{
+    size_t i = 0;
+    if constexpr (1 == sizeof(CharT))
+    {
+#ifdef _Z_SIMD_AVX2
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i a = fold_ascii_case(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p1 + i)));
+            __m256i b = fold_ascii_case(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p2 + i)));
+            std::uint32_t mask = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+            if (0 != mask)
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+#ifdef _Z_SIMD_SSE2
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i a = fold_ascii_case(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p1 + i)));
+            __m128i b = fold_ascii_case(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p2 + i)));
+            std::uint32_t mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xffff;
+            if (0 != mask)
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+    }
+    for (; i < length; ++i)
+    {
+        if (zed::fold_ascii_case(p1[i]) != zed::fold_ascii_case(p2[i]))
+            return i;
+    }
+    return length;
+}
+
+template <typename CharT>
+int compare_pieces_ignoring_case(const string_piece<CharT> &s1, const string_piece<CharT> &s2)
+{
+    size_t n = std::min(s1.length(), s2.length());
+    size_t i = mismatch_ignoring_case(s1.data(), s2.data(), n);
+    if (i < n)
+        return compare_chars_ignoring_case(s1[i], s2[i]);
+    return compare_chars(s1.length(), s2.length());
+}
+
+template <typename CharT>
+int compare_pszs_ignoring_case(const CharT *p1, const CharT *p2)
+{
+    for (;; ++p1, ++p2)
+    {
+        if (zed::fold_ascii_case(*p1) != zed::fold_ascii_case(*p2) || '\0' == *p1)
+            return compare_psz_chars_ignoring_case(*p1, *p2);
+    }
+}
+
+#ifdef _Z_SIMD_SSE2
+template <>
+ZED_NO_SANITIZE_ADDRESS inline int compare_pszs_ignoring_case<char>(const char *p1, const char *p2)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (;;)
+    {
+        if (!load_is_page_safe<16>(p1) || !load_is_page_safe<16>(p2))
+        {
+            if (zed::fold_ascii_case(*p1) != zed::fold_ascii_case(*p2) || '\0' == *p1)
+                return compare_psz_chars_ignoring_case(*p1, *p2);
+            ++p1; ++p2;
+            continue;
+        }
+
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p2));
+        std::uint32_t diff = ~_mm_movemask_epi8(_mm_cmpeq_epi8(fold_ascii_case(a), fold_ascii_case(b))) & 0xffff;
+        std::uint32_t terminated = _mm_movemask_epi8(_mm_cmpeq_epi8(a, zero));
+        if (std::uint32_t mask = diff | terminated)
+        {
+            unsigned i = count_trailing_zeros(mask);
+            return compare_psz_chars_ignoring_case(p1[i], p2[i]);
+        }
+        p1 += 16; p2 += 16;
+    }
+}
+#endif
+
+template <typename CharT>
+bool psz_equals_ignoring_case(const CharT *psz, const string_piece<CharT> &s)
+{
+    const CharT *end = std::char_traits<CharT>::find(psz, s.length() + 1, CharT());
+    if (end != psz + s.length())
+        return false;
+    return s.length() == mismatch_ignoring_case(psz, s.data(), s.length());
+}
+
+template <typename CharT>
+bool psz_equals(const CharT *psz, const string_piece<CharT> &s)
+{
+    // Never reads more than `s.length() + 1` chars of `psz`.
+    const CharT *end = std::char_traits<CharT>::find(psz, s.length() + 1, CharT());
+    if (end != psz + s.length())
+        return false;
+    return 0 == std::char_traits<CharT>::compare(psz, s.data(), s.length());
+}
+
+
+/**
+ * Searching Kernels
+ *
+ * Multi-char patterns are located by their first char first. If that char is too common,
+ * candidates are filtered by their first and last chars, a whole block of positions at once,
+ * and only the survivors get compared with `memcmp`.
+ */
+
+constexpr size_t max_simd_char_set = 8;
+
+#ifdef _Z_SIMD_AVX2
+inline std::uint32_t match_any_of(__m256i block, const __m256i *needles, size_t count)
+{
+    __m256i eq = _mm256_cmpeq_epi8(block, needles[0]);
+    for (size_t i = 1; i < count; ++i)
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, needles[i]));
+    return _mm256_movemask_epi8(eq);
+}
+#endif
+
+#ifdef _Z_SIMD_SSE2
+inline std::uint32_t match_any_of(__m128i block, const __m128i *needles, size_t count)
+{
+    __m128i eq = _mm_cmpeq_epi8(block, needles[0]);
+    for (size_t i = 1; i < count; ++i)
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, needles[i]));
+    return _mm_movemask_epi8(eq);
+}
+#endif
+
+inline size_t find_byte(const char *s, size_t n, char ch)
+{
+    // memchr is vectorized by every C runtime we support.
+    const void *p = 0 != n ? ::memchr(s, ch, n) : nullptr;
+    return nullptr != p ? static_cast<const char *>(p) - s : string_piece<char>::npos;
+}
+
+#ifdef _Z_SIMD_SSE2
+inline size_t filter_candidates(const char *s, size_t i, size_t candidates, const char *pattern, size_t m)
+{
+#   ifdef _Z_SIMD_AVX2
+    const __m256i first32 = _mm256_set1_epi8(pattern[0]);
+    const __m256i last32 = _mm256_set1_epi8(pattern[m - 1]);
+    for (; i + 32 <= candidates; i += 32)
+    {
+        __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i + m - 1));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(head, first32), _mm256_cmpeq_epi8(tail, last32));
+        for (std::uint32_t mask = _mm256_movemask_epi8(eq); 0 != mask; mask &= mask - 1)
+        {
+            size_t p = i + count_trailing_zeros(mask);
+            if (0 == ::memcmp(s + p + 1, pattern + 1, m - 2))
+                return p;
+        }
+    }
+#   endif
+    const __m128i first16 = _mm_set1_epi8(pattern[0]);
+    const __m128i last16 = _mm_set1_epi8(pattern[m - 1]);
+    for (; i + 16 <= candidates; i += 16)
+    {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + m - 1));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(head, first16), _mm_cmpeq_epi8(tail, last16));
+        for (std::uint32_t mask = _mm_movemask_epi8(eq); 0 != mask; mask &= mask - 1)
+        {
+            size_t p = i + count_trailing_zeros(mask);
+            if (0 == ::memcmp(s + p + 1, pattern + 1, m - 2))
+                return p;
+        }
+    }
+
+    for (; i < candidates; ++i)
+    {
+        if (s[i] == pattern[0] && s[i + m - 1] == pattern[m - 1] && 0 == ::memcmp(s + i + 1, pattern + 1, m - 2))
+            return i;
+    }
+    return string_piece<char>::npos;
+}
+#endif // _Z_SIMD_SSE2
+
+inline size_t find_bytes(const char *s, size_t n, const char *pattern, size_t m)
+{
+    if (m > n)
+        return string_piece<char>::npos;
+    if (m <= 1)
+        return 0 == m ? 0 : find_byte(s, n, pattern[0]);
+
+    // Scanning for the first char is the fastest way while it rarely shows up,
+    // once false candidates get dense, the first/last-char filter takes over.
+    const size_t candidates = n - m + 1;
+    size_t i = 0, false_candidates = 0;
+    while (i < candidates)
+    {
+        size_t p = find_byte(s + i, candidates - i, pattern[0]);
+        if (string_piece<char>::npos == p)
+            break;
+
+        i += p;
+        if (s[i + m - 1] == pattern[m - 1] && (2 == m || 0 == ::memcmp(s + i + 1, pattern + 1, m - 2)))
+            return i;
+        ++i;
+#ifdef _Z_SIMD_SSE2
+        if (++false_candidates >= 8 && false_candidates * 64 > i)
+            return filter_candidates(s, i, candidates, pattern, m);
+#endif
+    }
+    return string_piece<char>::npos;
+}
+
+inline size_t find_first_of_bytes(const char *s, size_t n, const char *chars, size_t count)
+{
+    if (1 == count)
+        return find_byte(s, n, chars[0]);
+
+    size_t i = 0;
+    if (0 != count && count <= max_simd_char_set)
+    {
+#ifdef _Z_SIMD_AVX2
+        __m256i needles32[max_simd_char_set];
+        for (size_t j = 0; j < count; ++j)
+            needles32[j] = _mm256_set1_epi8(chars[j]);
+        for (; i + 32 <= n; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+            if (std::uint32_t mask = match_any_of(block, needles32, count))
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+#ifdef _Z_SIMD_SSE2
+        __m128i needles16[max_simd_char_set];
+        for (size_t j = 0; j < count; ++j)
+            needles16[j] = _mm_set1_epi8(chars[j]);
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            if (std::uint32_t mask = match_any_of(block, needles16, count))
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+    }
+
+    for (; i < n; ++i)
+    {
+        if (nullptr != std::char_traits<char>::find(chars, count, s[i]))
+            return i;
+    }
+    return string_piece<char>::npos;
+}
+
+/**
+ * Runs of chars in a set (such as whitespace) and tokens before stop chars are usually short, so they are
+ * checked char by char first, long runs are then scanned a block at a time if the set is small enough.
+ */
+
+constexpr size_t short_run_length = 16;
+
+inline size_t find_first_in(const char *s, size_t n, const char_set &set)
+{
+    size_t i = 0;
+    for (size_t e = std::min(n, short_run_length); i < e; ++i)
+    {
+        if (set.contains(s[i]))
+            return i;
+    }
+    if (i == n)
+        return string_piece<char>::npos;
+
+    char members[max_simd_char_set];
+    size_t count = set.members(members, max_simd_char_set);
+    if (count <= max_simd_char_set)
+    {
+        size_t r = find_first_of_bytes(s + i, n - i, members, count);
+        return string_piece<char>::npos != r ? i + r : r;
+    }
+
+    for (; i < n; ++i)
+    {
+        if (set.contains(s[i]))
+            return i;
+    }
+    return string_piece<char>::npos;
+}
+
+inline size_t find_first_not_in(const char *s, size_t n, const char_set &set)
+{
+    size_t i = 0;
+    for (size_t e = std::min(n, short_run_length); i < e; ++i)
+    {
+        if (!set.contains(s[i]))
+            return i;
+    }
+
+#ifdef _Z_SIMD_SSE2
+    char members[max_simd_char_set];
+    size_t count = i < n ? set.members(members, max_simd_char_set) : 0;
+    if (0 != count && count <= max_simd_char_set)
+    {
+#   ifdef _Z_SIMD_AVX2
+        __m256i needles32[max_simd_char_set];
+        for (size_t j = 0; j < count; ++j)
+            needles32[j] = _mm256_set1_epi8(members[j]);
+        for (; i + 32 <= n; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+            if (std::uint32_t mask = ~match_any_of(block, needles32, count))
+                return i + count_trailing_zeros(mask);
+        }
+#   endif
+        __m128i needles16[max_simd_char_set];
+        for (size_t j = 0; j < count; ++j)
+            needles16[j] = _mm_set1_epi8(members[j]);
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            if (std::uint32_t mask = ~match_any_of(block, needles16, count) & 0xffff)
+                return i + count_trailing_zeros(mask);
+        }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        if (!set.contains(s[i]))
+            return i;
+    }
+    return string_piece<char>::npos;
+}
+
+inline size_t find_last_not_in(const char *s, size_t n, const char_set &set)
+{
+    size_t i = n;
+    for (size_t e = n - std::min(n, short_run_length); i > e; --i)
+    {
+        if (!set.contains(s[i - 1]))
+            return i - 1;
+    }
+
+#ifdef _Z_SIMD_SSE2
+    char members[max_simd_char_set];
+    size_t count = i > 0 ? set.members(members, max_simd_char_set) : 0;
+    if (0 != count && count <= max_simd_char_set)
+    {
+        __m128i needles[max_simd_char_set];
+        for (size_t j = 0; j < count; ++j)
+            needles[j] = _mm_set1_epi8(members[j]);
+        for (; i >= 16; i -= 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i - 16));
+            if (std::uint32_t mask = ~match_any_of(block, needles, count) & 0xffff)
+                return i - 16 + highest_bit_index(mask);
+        }
+    }
+#endif
+
+    while (i > 0)
+    {
+        if (!set.contains(s[--i]))
+            return i;
+    }
+    return string_piece<char>::npos;
+}
+
+// Returns the first char in `chars`, or the terminator.
+ZED_NO_SANITIZE_ADDRESS inline const char* find_first_of_psz(const char *psz, const char *chars)
+{
+    size_t count = std::char_traits<char>::length(chars);
+#ifdef _Z_SIMD_SSE2
+    if (count < max_simd_char_set)
+    {
+        __m128i needles[max_simd_char_set];
+        needles[0] = _mm_setzero_si128();
+        for (size_t j = 0; j < count; ++j)
+            needles[j + 1] = _mm_set1_epi8(chars[j]);
+
+        for (;;)
+        {
+            if (!load_is_page_safe<16>(psz))
+            {
+                if ('\0' == *psz || nullptr != std::char_traits<char>::find(chars, count, *psz))
+                    return psz;
+                ++psz;
+                continue;
+            }
+
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(psz));
+            if (std::uint32_t mask = match_any_of(block, needles, count + 1))
+                return psz + count_trailing_zeros(mask);
+            psz += 16;
+        }
+    }
+#endif
+    while ('\0' != *psz && nullptr == std::char_traits<char>::find(chars, count, *psz))
+        ++psz;
+    return psz;
+}
+
+// Returns the first char in `set`, or the terminator.
+inline const char* find_first_in_psz(const char *psz, const char_set &set)
+{
+    char members[max_simd_char_set + 1];
+    size_t count = set.members(members, max_simd_char_set);
+    if (count <= max_simd_char_set && !set.contains('\0'))
+    {
+        members[count] = '\0';
+        return find_first_of_psz(psz, members);
+    }
+
+    while ('\0' != *psz && !set.contains(*psz))
+        ++psz;
+    return psz;
+}
+
 } // namespace detail
 
 #ifndef _Z_STRING_VIEW_ENABLED
@@ -314,61 +1014,192 @@ string_piece<CharT> string_piece<CharT>::substr(size_type pos, size_type count)
 template <typename S1, typename S2, typename>
 int strcmp(const S1 &s1, const S2 &s2)
 {
-    detail::char_iterator it1(s1);
-    detail::char_iterator it2(s2);
-    while (!it1.reach_the_end() && !it2.reach_the_end())
+    using traits1 = detail::string_traits<S1>;
+    using traits2 = detail::string_traits<S2>;
+    if constexpr (traits1::is_psz && traits2::is_psz)
+        return detail::compare_pszs(traits1::psz(s1), traits2::psz(s2));
+    else
+        return detail::compare_pieces(traits1::piece(s1), traits2::piece(s2));
+}
+
+template <typename S1, typename S2, typename>
+bool strequ(const S1 &s1, const S2 &s2)
+{
+    using traits1 = detail::string_traits<S1>;
+    using traits2 = detail::string_traits<S2>;
+    if constexpr (traits1::is_psz && traits2::is_psz)
     {
-        auto c1 = *it1;
-        auto c2 = *it2;
-        if (c1 != c2)
-        {
-            if (c1 > c2)
-                return 1;
-            if (c1 < c2)
-                return -1;
-        }
-        ++it1; ++it2;
+        return 0 == detail::compare_pszs(traits1::psz(s1), traits2::psz(s2));
+    }
+    else if constexpr (traits1::is_psz)
+    {
+        return detail::psz_equals(traits1::psz(s1), traits2::piece(s2));
+    }
+    else if constexpr (traits2::is_psz)
+    {
+        return detail::psz_equals(traits2::psz(s2), traits1::piece(s1));
+    }
+    else
+    {
+        auto p1 = traits1::piece(s1);
+        auto p2 = traits2::piece(s2);
+        if (p1.length() != p2.length())
+            return false;
+        return 0 == std::char_traits<typename traits1::char_type>::compare(p1.data(), p2.data(), p1.length());
     }
-
-    if (!it1.reach_the_end())
-        return 1;
-    if (!it2.reach_the_end())
-        return -1;
-    return 0;
 }
 
 template <typename S1, typename S2, typename>
 int stricmp(const S1 &s1, const S2 &s2)
 {
-    detail::char_iterator it1(s1);
-    detail::char_iterator it2(s2);
-    while (!it1.reach_the_end() && !it2.reach_the_end())
+    using traits1 = detail::string_traits<S1>;
+    using traits2 = detail::string_traits<S2>;
+    if constexpr (traits1::is_psz && traits2::is_psz)
+        return detail::compare_pszs_ignoring_case(traits1::psz(s1), traits2::psz(s2));
+    else
+        return detail::compare_pieces_ignoring_case(traits1::piece(s1), traits2::piece(s2));
+}
+
+template <typename S1, typename S2, typename>
+bool striequ(const S1 &s1, const S2 &s2)
+{
+    using traits1 = detail::string_traits<S1>;
+    using traits2 = detail::string_traits<S2>;
+    if constexpr (traits1::is_psz && traits2::is_psz)
+    {
+        return 0 == detail::compare_pszs_ignoring_case(traits1::psz(s1), traits2::psz(s2));
+    }
+    else if constexpr (traits1::is_psz)
+    {
+        return detail::psz_equals_ignoring_case(traits1::psz(s1), traits2::piece(s2));
+    }
+    else if constexpr (traits2::is_psz)
+    {
+        return detail::psz_equals_ignoring_case(traits2::psz(s2), traits1::piece(s1));
+    }
+    else
+    {
+        auto p1 = traits1::piece(s1);
+        auto p2 = traits2::piece(s2);
+        if (p1.length() != p2.length())
+            return false;
+        return p1.length() == detail::mismatch_ignoring_case(p1.data(), p2.data(), p1.length());
+    }
+}
+
+template <typename CharT>
+size_t find_char(const string_piece<CharT> &s, CharT ch, size_t pos)
+{
+    if (pos >= s.length())
+        return string_piece<CharT>::npos;
+
+    size_t p;
+    if constexpr (std::is_same<CharT, char>::value)
     {
-        auto c1 = *it1;
-        auto c2 = *it2;
-        if (c1 != c2)
+        p = detail::find_byte(s.data() + pos, s.length() - pos, ch);
+    }
+    else
+    {
+        const CharT *found = std::char_traits<CharT>::find(s.data() + pos, s.length() - pos, ch);
+        p = nullptr != found ? found - s.data() - pos : string_piece<CharT>::npos;
+    }
+    return string_piece<CharT>::npos != p ? pos + p : p;
+}
+
+template <typename CharT>
+size_t find_string(const string_piece<CharT> &s, const string_piece<CharT> &pattern, size_t pos)
+{
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        if (pos > s.length())
+            return string_piece<CharT>::npos;
+
+        size_t p = detail::find_bytes(s.data() + pos, s.length() - pos, pattern.data(), pattern.length());
+        return string_piece<CharT>::npos != p ? pos + p : p;
+    }
+    else
+    {
+        return s.find(pattern, pos);
+    }
+}
+
+template <typename CharT>
+size_t find_first_of(const string_piece<CharT> &s, const string_piece<CharT> &chars, size_t pos)
+{
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        if (pos >= s.length())
+            return string_piece<CharT>::npos;
+
+        size_t p = detail::find_first_of_bytes(s.data() + pos, s.length() - pos, chars.data(), chars.length());
+        return string_piece<CharT>::npos != p ? pos + p : p;
+    }
+    else
+    {
+        return s.find_first_of(chars, pos);
+    }
+}
+
+template <typename CharT>
+size_t find_first_of(const string_piece<CharT> &s, const char_set &set, size_t pos)
+{
+    if (pos >= s.length())
+        return string_piece<CharT>::npos;
+
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        size_t p = detail::find_first_in(s.data() + pos, s.length() - pos, set);
+        return string_piece<CharT>::npos != p ? pos + p : p;
+    }
+    else
+    {
+        for (size_t i = pos; i < s.length(); ++i)
         {
-            if (zed::isalpha(c1) && zed::isalpha(c2))
-            {
-                if (isupper(c1))
-                    c1 = std::tolower(c1);
-                if (isupper(c2))
-                    c2 = std::tolower(c2);
-            }
+            if (set.contains(s[i]))
+                return i;
+        }
+        return string_piece<CharT>::npos;
+    }
+}
+
+template <typename CharT>
+size_t find_first_not_of(const string_piece<CharT> &s, const char_set &set, size_t pos)
+{
+    if (pos >= s.length())
+        return string_piece<CharT>::npos;
 
-            if (c1 > c2)
-                return 1;
-            if (c1 < c2)
-                return -1;
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        size_t p = detail::find_first_not_in(s.data() + pos, s.length() - pos, set);
+        return string_piece<CharT>::npos != p ? pos + p : p;
+    }
+    else
+    {
+        for (size_t i = pos; i < s.length(); ++i)
+        {
+            if (!set.contains(s[i]))
+                return i;
         }
-        ++it1; ++it2;
+        return string_piece<CharT>::npos;
     }
+}
 
-    if (!it1.reach_the_end())
-        return 1;
-    if (!it2.reach_the_end())
-        return -1;
-    return 0;
+template <typename CharT>
+size_t find_last_not_of(const string_piece<CharT> &s, const char_set &set)
+{
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        return detail::find_last_not_in(s.data(), s.length(), set);
+    }
+    else
+    {
+        for (size_t i = s.length(); i > 0; --i)
+        {
+            if (!set.contains(s[i - 1]))
+                return i - 1;
+        }
+        return string_piece<CharT>::npos;
+    }
 }
 
 } // namespace zed
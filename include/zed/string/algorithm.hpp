@@ -12,6 +12,9 @@
 #ifndef ZED_STRING_ALGORITHM_HPP
 #define ZED_STRING_ALGORITHM_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 #include "../ctype.hpp"
 #include "../string.hpp"
@@ -38,6 +41,117 @@ std::vector<string_piece<typename String::value_type>> split(const String &src,
 template <typename CharT>
 std::vector<string_piece<CharT>> split(const CharT *src, const CharT *separator);
 
+/**
+ * Lazy splitting, pieces are found and trimmed one at a time, no allocations involved.
+ * Like `split`, empty pieces (after trimming) are skipped.
+ *
+ * for (string_piece<char> piece : split_view(query, "&"))
+ *     ...
+ */
+
+template <typename CharT>
+class split_range
+{
+public:
+    using piece_type = string_piece<CharT>;
+
+    explicit split_range(const piece_type &s, const piece_type &separator) : m_s(s), m_separator(separator) {}
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = piece_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const piece_type *;
+        using reference = const piece_type &;
+
+        iterator(void) = default;
+
+        reference operator*(void) const { return m_current; }
+        pointer operator->(void) const { return &m_current; }
+
+        iterator& operator++(void);
+        iterator operator++(int)
+        {
+            iterator ret(*this);
+            ++(*this);
+            return ret;
+        }
+
+        bool operator==(const iterator &o) const { return m_current.data() == o.m_current.data(); }
+        bool operator!=(const iterator &o) const { return m_current.data() != o.m_current.data(); }
+    private:
+        friend class split_range;
+        explicit iterator(const split_range *range) : m_range(range), m_next(0) { ++(*this); }
+
+        const split_range *m_range = nullptr;
+        size_t m_next = piece_type::npos;
+        piece_type m_current;
+    };
+
+    iterator begin(void) const { return iterator(this); }
+    iterator end(void) const { return iterator(); }
+private:
+    const piece_type m_s, m_separator;
+};
+
+template <typename String>
+split_range<typename String::value_type> split_view(const String &src, const typename String::value_type *separator);
+
+template <typename CharT>
+split_range<CharT> split_view(const CharT *src, const CharT *separator);
+
+// The callback receives each piece, it may return false to stop splitting.
+template <typename String, class Callback>
+void for_each_split(const String &src, const typename String::value_type *separator, const Callback &callback);
+
+template <typename CharT, class Callback>
+void for_each_split(const CharT *src, const CharT *separator, const Callback &callback);
+
+/**
+ * ASCII Case Conversion
+ *
+ * Only ASCII letters are converted, other chars are copied as they are, no locales are involved.
+ */
+
+// `dst` may be the same as `src`.
+template <typename CharT>
+void to_lower_ascii(CharT *dst, const CharT *src, size_t length);
+
+template <typename String>
+std::basic_string<typename String::value_type> to_lower_ascii(const String &s);
+
+template <typename CharT>
+std::basic_string<CharT> to_lower_ascii(const CharT *psz);
+
+template <typename CharT>
+void to_lower_ascii(std::basic_string<CharT> *s);
+
+template <typename CharT>
+void to_upper_ascii(CharT *dst, const CharT *src, size_t length);
+
+template <typename String>
+std::basic_string<typename String::value_type> to_upper_ascii(const String &s);
+
+template <typename CharT>
+std::basic_string<CharT> to_upper_ascii(const CharT *psz);
+
+template <typename CharT>
+void to_upper_ascii(std::basic_string<CharT> *s);
+
+/**
+ * Classification
+ *
+ * Narrow strings are checked 32 chars per iteration. Empty strings always pass.
+ */
+
+template <typename String>
+bool all_ascii(const String &s);
+
+template <typename String>
+bool all_digits(const String &s);
+
 /**
  * Trimming Stuff
  */
@@ -74,59 +188,146 @@ void trim(std::basic_string<CharT> *s, const CharT *chars_to_trim = ascii_whites
 
 namespace detail {
 
+template <typename Adaptor>
+string_piece<typename Adaptor::char_type> trim(const Adaptor &s, const typename Adaptor::char_type *chars_to_trim);
+
 template <typename CharT>
-size_t pszlen(const CharT *psz)
+std::vector<string_piece<CharT>> split(const split_range<CharT> &range)
 {
-    size_t l = 0;
-    while ('\0' != *psz)
+    return std::vector<string_piece<CharT>>(range.begin(), range.end());
+}
+
+template <typename CharT, class Callback>
+void for_each_split(const split_range<CharT> &range, const Callback &callback)
+{
+    for (const string_piece<CharT> &piece : range)
     {
-        ++psz; ++l;
+        if constexpr (std::is_same<decltype(callback(piece)), bool>::value)
+        {
+            if (!callback(piece))
+                break;
+        }
+        else
+        {
+            callback(piece);
+        }
     }
-    return l;
 }
 
-template <typename Adaptor>
-string_piece<typename Adaptor::char_type> trim(const Adaptor &s, const typename Adaptor::char_type *chars_to_trim);
-
-template <class Adaptor>
-std::vector<string_piece<typename Adaptor::char_type>> split(const Adaptor &s, const typename Adaptor::char_type *separator)
+constexpr std::uint64_t repeat_byte(unsigned char b)
 {
-    using piece_type = string_piece<typename Adaptor::char_type>;
+    return 0x0101010101010101ULL * b;
+}
 
-    std::vector<piece_type> ret;
-    auto trim_chars = ascii_whitespace<typename Adaptor::char_type>::chars;
+inline bool all_ascii_bytes(const char *s, size_t n)
+{
+    size_t i = 0;
+#if defined(_Z_SIMD_AVX2)
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        if (0 != _mm256_movemask_epi8(v))
+            return false;
+    }
+#elif defined(_Z_SIMD_SSE2)
+    for (; i + 32 <= n; i += 32)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 16));
+        if (0 != _mm_movemask_epi8(_mm_or_si128(a, b)))
+            return false;
+    }
+#else
+    for (; i + 32 <= n; i += 32)
+    {
+        std::uint64_t w[4];
+        ::memcpy(w, s + i, sizeof(w));
+        if (0 != ((w[0] | w[1] | w[2] | w[3]) & repeat_byte(0x80)))
+            return false;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (0 != (s[i] & 0x80))
+            return false;
+    }
+    return true;
+}
 
-    size_t b = 0;
-    size_t e = s.find(separator, b);
-    size_t l = pszlen(separator);
-    while (Adaptor::npos != e)
+inline bool all_digit_bytes(const char *s, size_t n)
+{
+    size_t i = 0;
+#if defined(_Z_SIMD_AVX2)
+    // Signed compares only: shift '0'..'9' to the bottom of the signed range first.
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80 - '0'));
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(0x80 + 10));
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i)), bias);
+        if (-1 != _mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, v)))
+            return false;
+    }
+#elif defined(_Z_SIMD_SSE2)
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - '0'));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(0x80 + 10));
+    for (; i + 32 <= n; i += 32)
+    {
+        __m128i a = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i)), bias);
+        __m128i b = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + 16)), bias);
+        __m128i digits = _mm_and_si128(_mm_cmplt_epi8(a, limit), _mm_cmplt_epi8(b, limit));
+        if (0xffff != _mm_movemask_epi8(digits))
+            return false;
+    }
+#else
+    for (; i + 32 <= n; i += 32)
     {
-        piece_type tmp = s.sub_piece(b, e - b);
-        if (!tmp.empty())
+        std::uint64_t w[4];
+        ::memcpy(w, s + i, sizeof(w));
+        for (std::uint64_t x : w)
         {
-            tmp = trim(string_adaptor<piece_type>(tmp), trim_chars);
-            if (!tmp.empty())
-                ret.push_back(tmp);
+            // High nibbles must be 3, and low nibbles must not carry when 6 is added.
+            if ((x & repeat_byte(0xf0)) != repeat_byte(0x30) || ((x + repeat_byte(0x06)) & repeat_byte(0xf0)) != repeat_byte(0x30))
+                return false;
         }
-
-        b = e + l;
-        e = s.find(separator, b);
     }
+#endif
+    for (; i < n; ++i)
+    {
+        if (!zed::isdigit(s[i]))
+            return false;
+    }
+    return true;
+}
 
-    piece_type left = s.sub_piece(b);
-    if (!left.empty())
+// Chars to trim are looked up in a `char_set`, unless some of them are out of its range.
+template <typename CharT>
+bool fits_char_set(const CharT *chars)
+{
+    if constexpr (1 < sizeof(CharT))
     {
-        left = trim(string_adaptor<piece_type>(left), trim_chars);
-        if (!left.empty())
-            ret.push_back(left);
+        for (; '\0' != *chars; ++chars)
+        {
+            if (static_cast<std::make_unsigned_t<CharT>>(*chars) > 0xff)
+                return false;
+        }
     }
-    return ret;
+    return true;
+}
+
+template <typename CharT>
+char_set make_trim_set(const CharT *chars)
+{
+    return ascii_whitespace<CharT>::chars == chars ? ascii_whitespace<CharT>::set : char_set(chars);
 }
 
 template <typename Adaptor>
 string_piece<typename Adaptor::char_type> trim_left(const Adaptor &s, const typename Adaptor::char_type *chars_to_trim)
 {
-    size_t p = s.find_first_not_of(chars_to_trim);
+    size_t p;
+    if (fits_char_set(chars_to_trim))
+        p = s.find_first_not_of(make_trim_set(chars_to_trim));
+    else
+        p = s.find_first_not_of(chars_to_trim);
     if (Adaptor::npos == p)
         p = 0;
     return s.sub_piece(p);
@@ -135,7 +336,11 @@ string_piece<typename Adaptor::char_type> trim_left(const Adaptor &s, const type
 template <typename Adaptor>
 string_piece<typename Adaptor::char_type> trim_right(const Adaptor &s, const typename Adaptor::char_type *chars_to_trim)
 {
-    size_t p = s.find_last_not_of(chars_to_trim);
+    size_t p;
+    if (fits_char_set(chars_to_trim))
+        p = s.find_last_not_of(make_trim_set(chars_to_trim));
+    else
+        p = s.find_last_not_of(chars_to_trim);
     return Adaptor::npos != p ? s.sub_piece(0, p + 1) : string_piece<typename Adaptor::char_type>();
 }
 
@@ -156,7 +361,10 @@ std::basic_string<CharT> replace(const std::basic_string_view<CharT> &src, const
     std::basic_string<CharT> ret;
 
     size_t b = 0, e, l = old_sub.length();
-    while ((e = src.find(old_sub, b)) != std::basic_string_view<CharT>::npos)
+    if (0 == l)
+        return std::basic_string<CharT>(src);
+
+    while ((e = find_string(src, old_sub, b)) != std::basic_string_view<CharT>::npos)
     {
         ret.append(src, b, e - b).append(new_sub);
         b = e + l;
@@ -176,18 +384,150 @@ std::basic_string<typename chartype_trait<S1>::char_type> replace(const S1 &src,
     return replace<char_type>(string_view_type(src), string_view_type(new_sub), string_view_type(old_sub));
 }
 
+template <typename CharT>
+typename split_range<CharT>::iterator& split_range<CharT>::iterator::operator++(void)
+{
+    const piece_type &s = m_range->m_s;
+    const piece_type &separator = m_range->m_separator;
+    while (piece_type::npos != m_next)
+    {
+        size_t b = m_next;
+        size_t e = separator.empty() ? piece_type::npos : find_string(s, separator, b);
+        if (piece_type::npos != e)
+        {
+            m_next = e + separator.length();
+        }
+        else
+        {
+            e = s.length();
+            m_next = piece_type::npos;
+        }
+
+        if (b < e)
+        {
+            m_current = detail::trim(detail::string_adaptor<piece_type>(s.substr(b, e - b)), ascii_whitespace<CharT>::chars);
+            if (!m_current.empty())
+                return *this;
+        }
+    }
+
+    m_current = piece_type();
+    return *this;
+}
+
 template <typename String>
 std::vector<string_piece<typename String::value_type>> split(const String &s, const typename String::value_type *separator)
 {
-    detail::string_adaptor<String> adaptor(s);
-    return detail::split(adaptor, separator);
+    return detail::split(split_view(s, separator));
 }
 
 template <typename CharT>
 std::vector<string_piece<CharT>> split(const CharT *ps, const CharT *separator)
 {
-    detail::string_adaptor<const CharT *> adaptor(ps);
-    return detail::split(adaptor, separator);
+    return detail::split(split_view(ps, separator));
+}
+
+template <typename String>
+split_range<typename String::value_type> split_view(const String &s, const typename String::value_type *separator)
+{
+    using piece_type = string_piece<typename String::value_type>;
+    return split_range<typename String::value_type>(piece_type(s.data(), s.length()), piece_type(separator));
+}
+
+template <typename CharT>
+split_range<CharT> split_view(const CharT *ps, const CharT *separator)
+{
+    return split_range<CharT>(string_piece<CharT>(ps), string_piece<CharT>(separator));
+}
+
+template <typename String, class Callback>
+void for_each_split(const String &s, const typename String::value_type *separator, const Callback &callback)
+{
+    detail::for_each_split(split_view(s, separator), callback);
+}
+
+template <typename CharT, class Callback>
+void for_each_split(const CharT *ps, const CharT *separator, const Callback &callback)
+{
+    detail::for_each_split(split_view(ps, separator), callback);
+}
+
+template <typename CharT>
+void to_lower_ascii(CharT *dst, const CharT *src, size_t length)
+{
+    detail::convert_ascii_case<false>(dst, src, length);
+}
+
+template <typename String>
+std::basic_string<typename String::value_type> to_lower_ascii(const String &s)
+{
+    std::basic_string<typename String::value_type> ret(s.data(), s.length());
+    to_lower_ascii(&ret);
+    return ret;
+}
+
+template <typename CharT>
+std::basic_string<CharT> to_lower_ascii(const CharT *psz)
+{
+    std::basic_string<CharT> ret(psz);
+    to_lower_ascii(&ret);
+    return ret;
+}
+
+template <typename CharT>
+void to_lower_ascii(std::basic_string<CharT> *s)
+{
+    detail::convert_ascii_case<false>(s->data(), s->data(), s->length());
+}
+
+template <typename CharT>
+void to_upper_ascii(CharT *dst, const CharT *src, size_t length)
+{
+    detail::convert_ascii_case<true>(dst, src, length);
+}
+
+template <typename String>
+std::basic_string<typename String::value_type> to_upper_ascii(const String &s)
+{
+    std::basic_string<typename String::value_type> ret(s.data(), s.length());
+    to_upper_ascii(&ret);
+    return ret;
+}
+
+template <typename CharT>
+std::basic_string<CharT> to_upper_ascii(const CharT *psz)
+{
+    std::basic_string<CharT> ret(psz);
+    to_upper_ascii(&ret);
+    return ret;
+}
+
+template <typename CharT>
+void to_upper_ascii(std::basic_string<CharT> *s)
+{
+    detail::convert_ascii_case<true>(s->data(), s->data(), s->length());
+}
+
+template <typename String>
+bool all_ascii(const String &s)
+{
+    using traits = detail::string_traits<String>;
+    auto piece = traits::piece(s);
+    if constexpr (1 == sizeof(typename traits::char_type))
+        return detail::all_ascii_bytes(reinterpret_cast<const char *>(piece.data()), piece.length());
+    else
+        return std::all_of(piece.begin(), piece.end(), [](auto ch) { return 0 <= ch && ch < 0x80; });
+}
+
+template <typename String>
+bool all_digits(const String &s)
+{
+    using traits = detail::string_traits<String>;
+    auto piece = traits::piece(s);
+    if constexpr (1 == sizeof(typename traits::char_type))
+        return detail::all_digit_bytes(reinterpret_cast<const char *>(piece.data()), piece.length());
+    else
+        return std::all_of(piece.begin(), piece.end(), [](auto ch) { return zed::isdigit(ch); });
 }
 
 template <typename String>
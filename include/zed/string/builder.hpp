@@ -0,0 +1,259 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: builder.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_STRING_BUILDER_HPP
+#define ZED_STRING_BUILDER_HPP
+
+#include <memory_resource>
+#include <new>
+#include <vector>
+#include "../string.hpp"
+#ifdef _Z_OS_POSIX
+#   include <sys/uio.h>
+#endif
+
+namespace zed {
+
+/**
+ * String Builders
+ *
+ * Appended chars go into a chain of chunks, each twice as large as the previous one (up to
+ * `max_chunk_size`), so nothing written is ever moved until the result is flattened once by
+ * `str`/`append_to`, or handed out chunk by chunk (e.g. to `writev`) without flattening at all.
+ *
+ * Chunks come from a `std::pmr::memory_resource`, pass a `std::pmr::monotonic_buffer_resource`
+ * to build strings in an arena.
+ */
+
+template <typename CharT>
+class basic_string_builder
+{
+public:
+    static constexpr size_t min_chunk_size = 256;
+    static constexpr size_t max_chunk_size = 1024 * 1024;
+    // Outputs smaller than this are cheaper to build in a reserved `std::basic_string`, which
+    // takes one allocation and no flattening.
+    static constexpr size_t min_worthwhile_size = 4096;
+
+    explicit basic_string_builder(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    ~basic_string_builder(void) { release(); }
+
+    basic_string_builder(const basic_string_builder &) = delete;
+    basic_string_builder& operator=(const basic_string_builder &) = delete;
+
+    // Makes sure the next `n` chars go into a single chunk, for callers which can estimate their output.
+    void reserve_hint(size_t n);
+
+    void append(const CharT *s, size_t n);
+    void append(const string_piece<CharT> &s) { append(s.data(), s.length()); }
+    void append(size_t n, CharT ch);
+    void push_back(CharT ch);
+    basic_string_builder& operator+=(const string_piece<CharT> &s) { append(s); return *this; }
+    basic_string_builder& operator+=(CharT ch) { push_back(ch); return *this; }
+
+    // Returns room for `n` contiguous chars, `commit` how many of them are written.
+    CharT* prepare(size_t n);
+    void commit(size_t n);
+
+    size_t size(void) const { return m_size; }
+    bool empty(void) const { return 0 == m_size; }
+    void clear(void);
+
+    std::basic_string<CharT> str(void) const;
+    void append_to(std::basic_string<CharT> &dst) const;
+
+    template <typename Callback>
+    void for_each_chunk(const Callback &callback) const;
+#ifdef _Z_OS_POSIX
+    // Chars are not copied, the vectors are valid until the builder changes.
+    std::vector<struct iovec> iovecs(void) const;
+#endif
+private:
+    struct chunk {
+        chunk *next;
+        size_t capacity, size;
+
+        CharT* data(void) { return reinterpret_cast<CharT *>(this + 1); }
+        const CharT* data(void) const { return reinterpret_cast<const CharT *>(this + 1); }
+        size_t room(void) const { return capacity - size; }
+    };
+
+    void add_chunk(size_t min_capacity);
+    void release(void);
+
+    std::pmr::memory_resource *m_resource;
+    chunk *m_head = nullptr, *m_tail = nullptr;
+    size_t m_next_capacity = min_chunk_size;
+    size_t m_size = 0;
+};
+
+using string_builder = basic_string_builder<char>;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+template <typename CharT>
+basic_string_builder<CharT>::basic_string_builder(std::pmr::memory_resource *resource) : m_resource(resource)
+{
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::add_chunk(size_t min_capacity)
+{
+    size_t capacity = std::max(m_next_capacity, min_capacity);
+    void *p = m_resource->allocate(sizeof(chunk) + capacity * sizeof(CharT), alignof(chunk));
+
+    chunk *c = new (p) chunk{ nullptr, capacity, 0 };
+    if (nullptr != m_tail)
+        m_tail->next = c;
+    else
+        m_head = c;
+    m_tail = c;
+
+    m_next_capacity = std::min(2 * m_next_capacity, max_chunk_size);
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::append(const CharT *s, size_t n)
+{
+    while (n > 0)
+    {
+        if (nullptr == m_tail || 0 == m_tail->room())
+            add_chunk(0);
+
+        size_t count = std::min(n, m_tail->room());
+        std::char_traits<CharT>::copy(m_tail->data() + m_tail->size, s, count);
+        m_tail->size += count;
+        m_size += count;
+        s += count; n -= count;
+    }
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::append(size_t n, CharT ch)
+{
+    while (n > 0)
+    {
+        if (nullptr == m_tail || 0 == m_tail->room())
+            add_chunk(0);
+
+        size_t count = std::min(n, m_tail->room());
+        std::char_traits<CharT>::assign(m_tail->data() + m_tail->size, count, ch);
+        m_tail->size += count;
+        m_size += count;
+        n -= count;
+    }
+}
+
+template <typename CharT>
+std::basic_string<CharT> basic_string_builder<CharT>::str(void) const
+{
+    std::basic_string<CharT> ret;
+    append_to(ret);
+    return ret;
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::append_to(std::basic_string<CharT> &dst) const
+{
+    size_t offset = dst.length();
+    dst.resize(offset + m_size);
+
+    CharT *p = dst.data() + offset;
+    for (const chunk *c = m_head; nullptr != c; c = c->next)
+    {
+        std::char_traits<CharT>::copy(p, c->data(), c->size);
+        p += c->size;
+    }
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::clear(void)
+{
+    release();
+    m_next_capacity = min_chunk_size;
+    m_size = 0;
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::commit(size_t n)
+{
+    ZASSERT(nullptr != m_tail && n <= m_tail->room());
+    m_tail->size += n;
+    m_size += n;
+}
+
+template <typename CharT>
+template <typename Callback>
+void basic_string_builder<CharT>::for_each_chunk(const Callback &callback) const
+{
+    for (const chunk *c = m_head; nullptr != c; c = c->next)
+    {
+        if (c->size > 0)
+            callback(string_piece<CharT>(c->data(), c->size));
+    }
+}
+
+#ifdef _Z_OS_POSIX
+template <typename CharT>
+std::vector<struct iovec> basic_string_builder<CharT>::iovecs(void) const
+{
+    std::vector<struct iovec> ret;
+    for_each_chunk([&ret](const string_piece<CharT> &s) {
+        struct iovec v;
+        v.iov_base = const_cast<CharT *>(s.data());
+        v.iov_len = s.length() * sizeof(CharT);
+        ret.push_back(v);
+    });
+    return ret;
+}
+#endif
+
+template <typename CharT>
+CharT* basic_string_builder<CharT>::prepare(size_t n)
+{
+    if (nullptr == m_tail || m_tail->room() < n)
+        add_chunk(n);
+    return m_tail->data() + m_tail->size;
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::push_back(CharT ch)
+{
+    if (nullptr == m_tail || 0 == m_tail->room())
+        add_chunk(0);
+    m_tail->data()[m_tail->size++] = ch;
+    ++m_size;
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::release(void)
+{
+    chunk *c = m_head;
+    while (nullptr != c)
+    {
+        chunk *next = c->next;
+        m_resource->deallocate(c, sizeof(chunk) + c->capacity * sizeof(CharT), alignof(chunk));
+        c = next;
+    }
+    m_head = m_tail = nullptr;
+}
+
+template <typename CharT>
+void basic_string_builder<CharT>::reserve_hint(size_t n)
+{
+    if (nullptr == m_tail || m_tail->room() < n)
+        add_chunk(n);
+}
+
+} // namespace zed
+
+#endif // ZED_STRING_BUILDER_HPP
@@ -13,10 +13,46 @@
 #define ZED_STRING_CONV_HPP
 
 #include "../platform_sdk.h"
-#include "../string.hpp"
+#include "./utf8.hpp"
 
 namespace zed {
 
+/**
+ * Unicode Conversions
+ *
+ * Portable and locale free. Ill-formed input never fails a conversion, each maximal ill-formed
+ * subsequence is replaced by U+FFFD instead. Runs of ASCII chars are converted 16 at a time.
+ *
+ * Results are appended to `dst`, which is sized by the upper bound first and trimmed afterwards,
+ * so the source is scanned only once.
+ * Char16/Char32 may be any 2/4-byte char type, so `std::wstring` works on both Windows and POSIX.
+ */
+
+constexpr size_t utf16_length_bound(size_t utf8_length) { return utf8_length; }
+constexpr size_t utf32_length_bound(size_t utf8_length) { return utf8_length; }
+constexpr size_t utf8_length_bound(size_t utf16_length) { return 3 * utf16_length; }
+
+// `dst` must have room for `utf16_length_bound(length)` units, returns the number of units written.
+template <typename Char16>
+size_t utf8_to_utf16(const char *src, size_t length, Char16 *dst);
+template <typename Char16>
+void utf8_to_utf16(const string_piece<char> &src, std::basic_string<Char16> &dst);
+std::u16string utf8_to_utf16(const string_piece<char> &src);
+
+// `dst` must have room for `utf8_length_bound(length)` bytes, returns the number of bytes written.
+template <typename Char16>
+size_t utf16_to_utf8(const Char16 *src, size_t length, char *dst);
+template <typename Char16>
+void utf16_to_utf8(const string_piece<Char16> &src, std::string &dst);
+template <typename Char16>
+std::string utf16_to_utf8(const string_piece<Char16> &src);
+
+template <typename Char32>
+size_t utf8_to_utf32(const char *src, size_t length, Char32 *dst);
+template <typename Char32>
+void utf8_to_utf32(const string_piece<char> &src, std::basic_string<Char32> &dst);
+std::u32string utf8_to_utf32(const string_piece<char> &src);
+
 #ifdef _Z_OS_WINDOWS
 std::wstring multi_byte_to_wide_string(const string_piece<char> &s, UINT cp = CP_UTF8);
 std::wstring multi_byte_to_wide_string(PCSTR psz, UINT cp = CP_UTF8);
@@ -31,22 +67,127 @@ inline std::string wide_string_to_multi_byte(const std::wstring &s, UINT cp = CP
 // Implementations
 
 namespace detail {
+
+// Widens leading ASCII chars 16 at a time, returns the number of chars converted.
+template <typename CharT>
+size_t widen_ascii(const char *src, size_t length, CharT *dst)
+{
+    size_t i = 0;
+#ifdef _Z_SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        if (0 != _mm_movemask_epi8(v))
+            break;
+
+        __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *p = reinterpret_cast<__m128i *>(dst + i);
+        if constexpr (2 == sizeof(CharT))
+        {
+            _mm_storeu_si128(p, lo);
+            _mm_storeu_si128(p + 1, hi);
+        }
+        else
+        {
+            _mm_storeu_si128(p, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(p + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(p + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(p + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#endif
+    return i;
+}
+
+template <typename Char16>
+size_t narrow_ascii(const Char16 *src, size_t length, char *dst)
+{
+    size_t i = 0;
+#ifdef _Z_SIMD_SSE2
+    const __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+        __m128i high_bits = _mm_and_si128(_mm_or_si128(a, b), non_ascii);
+        if (0xffff != _mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, zero)))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(a, b));
+    }
+#endif
+    return i;
+}
+
+template <typename CharT, size_t Width>
+size_t utf8_to_wide(const char *src, size_t length, CharT *dst)
+{
+    static_assert(Width == sizeof(CharT), "Unexpected char type!");
+
+    const unsigned char *s = reinterpret_cast<const unsigned char *>(src);
+    size_t i = 0, ret = 0;
+    while (i < length)
+    {
+        if (s[i] < 0x80)
+        {
+            size_t n = widen_ascii(src + i, length - i, dst + ret);
+            i += n; ret += n;
+            while (i < length && s[i] < 0x80)
+                dst[ret++] = static_cast<CharT>(s[i++]);
+            continue;
+        }
+
+        char32_t cp = decode_utf8(s, length, &i);
+        if constexpr (2 == Width)
+        {
+            if (cp >= 0x10000)
+            {
+                cp -= 0x10000;
+                dst[ret++] = static_cast<CharT>(0xd800 | (cp >> 10));
+                dst[ret++] = static_cast<CharT>(0xdc00 | (cp & 0x3ff));
+                continue;
+            }
+        }
+        dst[ret++] = static_cast<CharT>(cp);
+    }
+    return ret;
+}
+
+template <typename String, typename Converter>
+void append_converted(String &dst, size_t bound, const Converter &convert)
+{
+    size_t offset = dst.length();
+    dst.resize(offset + bound);
+    dst.resize(offset + convert(dst.data() + offset));
+}
+
 #ifdef _Z_OS_WINDOWS
 inline std::wstring multi_byte_to_wide_string(PCSTR ps, int length, UINT cp)
 {
     std::wstring ret;
-    int r = ::MultiByteToWideChar(cp, 0, ps, length, nullptr, 0);
-    if (r > 0)
+    if (CP_UTF8 == cp)
     {
-        ret.resize(r);
-        ::MultiByteToWideChar(cp, 0, ps, length, const_cast<PWSTR>(ret.c_str()), r + 1);
+        utf8_to_utf16(string_piece<char>(ps, length), ret);
+        return ret;
     }
+
+    // No code page produces more UTF-16 units than bytes.
+    ret.resize(length);
+    int r = length > 0 ? ::MultiByteToWideChar(cp, 0, ps, length, ret.data(), length) : 0;
+    ret.resize(r > 0 ? r : 0);
     return ret;
 }
 
 inline std::string wide_string_to_multi_byte(PCWSTR ps, int length, UINT cp)
 {
     std::string ret;
+    if (CP_UTF8 == cp)
+    {
+        utf16_to_utf8(string_piece<wchar_t>(ps, length), ret);
+        return ret;
+    }
+
     int r = ::WideCharToMultiByte(cp, 0, ps, length, nullptr, 0, nullptr, nullptr);
     if (r > 0)
     {
@@ -58,29 +199,113 @@ inline std::string wide_string_to_multi_byte(PCWSTR ps, int length, UINT cp)
 #endif // _Z_OS_WINDOWS
 } // namespace detail
 
+template <typename Char16>
+size_t utf8_to_utf16(const char *src, size_t length, Char16 *dst)
+{
+    return detail::utf8_to_wide<Char16, 2>(src, length, dst);
+}
+
+template <typename Char16>
+void utf8_to_utf16(const string_piece<char> &src, std::basic_string<Char16> &dst)
+{
+    detail::append_converted(dst, utf16_length_bound(src.length()), [&src](Char16 *p) {
+        return utf8_to_utf16(src.data(), src.length(), p);
+    });
+}
+
+inline std::u16string utf8_to_utf16(const string_piece<char> &src)
+{
+    std::u16string ret;
+    utf8_to_utf16(src, ret);
+    return ret;
+}
+
+template <typename Char16>
+size_t utf16_to_utf8(const Char16 *src, size_t length, char *dst)
+{
+    static_assert(2 == sizeof(Char16), "Unexpected char type!");
+
+    size_t i = 0, ret = 0;
+    while (i < length)
+    {
+        if (src[i] < 0x80)
+        {
+            size_t n = detail::narrow_ascii(src + i, length - i, dst + ret);
+            i += n; ret += n;
+            while (i < length && src[i] < 0x80)
+                dst[ret++] = static_cast<char>(src[i++]);
+            continue;
+        }
+
+        char32_t cp = src[i++];
+        if (0xd800 <= cp && cp <= 0xdfff)
+        {
+            if (cp <= 0xdbff && i < length && 0xdc00 <= src[i] && src[i] <= 0xdfff)
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (src[i++] - 0xdc00);
+            else
+                cp = detail::replacement_char;
+        }
+        ret += detail::encode_utf8(cp, dst + ret);
+    }
+    return ret;
+}
+
+template <typename Char16>
+void utf16_to_utf8(const string_piece<Char16> &src, std::string &dst)
+{
+    detail::append_converted(dst, utf8_length_bound(src.length()), [&src](char *p) {
+        return utf16_to_utf8(src.data(), src.length(), p);
+    });
+}
+
+template <typename Char16>
+std::string utf16_to_utf8(const string_piece<Char16> &src)
+{
+    std::string ret;
+    utf16_to_utf8(src, ret);
+    return ret;
+}
+
+template <typename Char32>
+size_t utf8_to_utf32(const char *src, size_t length, Char32 *dst)
+{
+    return detail::utf8_to_wide<Char32, 4>(src, length, dst);
+}
+
+template <typename Char32>
+void utf8_to_utf32(const string_piece<char> &src, std::basic_string<Char32> &dst)
+{
+    detail::append_converted(dst, utf32_length_bound(src.length()), [&src](Char32 *p) {
+        return utf8_to_utf32(src.data(), src.length(), p);
+    });
+}
+
+inline std::u32string utf8_to_utf32(const string_piece<char> &src)
+{
+    std::u32string ret;
+    utf8_to_utf32(src, ret);
+    return ret;
+}
+
 #ifdef _Z_OS_WINDOWS
 inline std::wstring multi_byte_to_wide_string(const string_piece<char> &s, UINT cp)
 {
-    return detail::multi_byte_to_wide_string(s.data(), s.length(), cp);
+    return detail::multi_byte_to_wide_string(s.data(), static_cast<int>(s.length()), cp);
 }
 
 inline std::wstring multi_byte_to_wide_string(PCSTR psz, UINT cp)
 {
-    std::wstring ret = detail::multi_byte_to_wide_string(psz, -1, cp);
-    ret.pop_back(); // for the last '\0'
-    return ret;
+    return detail::multi_byte_to_wide_string(psz, static_cast<int>(strlen(psz)), cp);
 }
 
 inline std::string wide_string_to_multi_byte(const string_piece<wchar_t> &s, UINT cp)
 {
-    return detail::wide_string_to_multi_byte(s.data(), s.length(), cp);
+    return detail::wide_string_to_multi_byte(s.data(), static_cast<int>(s.length()), cp);
 }
 
 inline std::string wide_string_to_multi_byte(PCWSTR psz, UINT cp)
 {
-    std::string ret = detail::wide_string_to_multi_byte(psz, -1, cp);
-    ret.pop_back(); // for the last '\0'
-    return ret;
+    return detail::wide_string_to_multi_byte(psz, static_cast<int>(wcslen(psz)), cp);
 }
 #endif // _Z_OS_WINDOWS
 
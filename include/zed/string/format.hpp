@@ -12,20 +12,33 @@
 #ifndef ZED_STRING_FORMAT_HPP
 #define ZED_STRING_FORMAT_HPP
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <functional>
+#include <limits>
 #include <utility>
 #include <vector>
 #include "../string.hpp"
+#include "./builder.hpp"
+#include "./number.hpp"
 
 namespace zed {
 
+template <class Literal>
+class format_string;
+
 template <typename... Args>
 std::string sequence_format(const char *fmt, const Args&... args);
 
+template <class Literal, typename... Args>
+std::string sequence_format(const format_string<Literal> &fmt, const Args&... args);
+
 struct default_arg_serializer {
     template <typename T>
-    static void push(std::vector<std::string> &dst, const T &arg) { dst.emplace_back(std::to_string(arg)); }
+    static void push(std::vector<std::string> &dst, const T &arg);
     static void push(std::vector<std::string> &dst, const char *psz) { dst.emplace_back(psz); }
+    static void push(std::vector<std::string> &dst, const string_piece<char> &s) { dst.emplace_back(s.data(), s.length()); }
 };
 
 template <class Serializer = default_arg_serializer>
@@ -37,6 +50,7 @@ public:
     using std::vector<std::string>::at;
     using std::vector<std::string>::size;
 
+    void collect_from(void) {}
     template <typename T>
     void collect_from(const T &arg) { Serializer::push(*this, arg); }
     template <typename Arg, typename... Args>
@@ -60,6 +74,79 @@ private:
     std::vector<part> m_parts;
 };
 
+/**
+ * Format Specifications
+ *
+ * Placeholders accept a subset of the std::format specification:
+ *
+ *   {:[[fill]align][sign][#][0][width][.precision][type]}
+ *
+ * e.g. "{:08x}", "{:.3f}", "{:>12}", "{:*^9}". Contents not starting with ':' are ignored.
+ * Widths and precisions above `max_width` / `max_precision` are invalid, as runtime formats may
+ * come from outside.
+ */
+
+struct format_spec {
+    char fill = ' ';
+    char align = '\0';     // '<', '>' or '^', numbers are right-aligned and others are left-aligned by default.
+    char sign = '-';       // '+', '-' or ' '
+    bool alternate = false;
+    bool zero_padding = false;
+    unsigned width = 0;
+    int precision = -1;
+    char type = '\0';      // "bBcdoxX" for integers, "eEfFgG" for floating-point numbers, 's' or 'p'
+
+    static constexpr unsigned max_width = 4096;
+    static constexpr int max_precision = 4096;
+
+    template <typename CharT>
+    static constexpr bool parse(const string_piece<CharT> &s, format_spec &dst);
+};
+
+/**
+ * Compile-time Format Strings
+ *
+ * Literals wrapped by `ZFMT` are split into raw and placeholder spans during compilation,
+ * and the count of placeholders is checked against the count of arguments.
+ *
+ *   zed::sequence_format(ZFMT("{}, {:.2f}!"), "Hello", 1.234);
+ */
+
+#define ZFMT(s) ::zed::detail::make_format_string([] { \
+        struct literal { static constexpr ::zed::string_piece<char> get(void) { return s; } }; \
+        return literal(); \
+    }())
+
+namespace detail {
+
+struct format_span {
+    enum type { raw, placeholder } m_type = raw;
+    size_t m_start = 0, m_length = 0;
+    format_spec m_spec;
+};
+
+template <typename CharT, class Spans>
+constexpr void parse_format_spans(const string_piece<CharT> &format, Spans &dst);
+
+template <typename CharT>
+constexpr size_t count_format_spans(const string_piece<CharT> &format);
+
+} // namespace detail
+
+template <class Literal>
+class format_string
+{
+public:
+    using spans = std::array<detail::format_span, detail::count_format_spans(Literal::get())>;
+
+    static constexpr spans parse(void);
+    static constexpr size_t placeholder_count(void);
+    static constexpr size_t raw_length(void);
+    static constexpr bool specs_valid(void);
+
+    static constexpr string_piece<char> source(void) { return Literal::get(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementations
 
@@ -82,6 +169,470 @@ std::string sequence_format(ArgsCollector &ac, const char *fmt, const Args&... a
     return formatter_impl<char>(fmt).format(callback);
 }
 
+template <class Literal>
+constexpr format_string<Literal> make_format_string(const Literal &)
+{
+    return format_string<Literal>();
+}
+
+template <size_t N>
+struct format_span_array
+{
+    std::array<format_span, N> spans;
+    size_t size = 0;
+
+    constexpr void push_back(const format_span &span) { spans[size++] = span; }
+};
+
+struct format_span_counter
+{
+    size_t size = 0;
+
+    constexpr void push_back(const format_span &) { ++size; }
+};
+
+template <typename CharT, class Spans>
+constexpr void parse_format_spans(const string_piece<CharT> &format, Spans &dst)
+{
+    // Keep in sync with `formatter_impl`.
+    format_span span;
+    format_span::type next_type = format_span::placeholder;
+    CharT flag_char = '{', next_flag_char = '}';
+    for (size_t i = 0; i < format.length(); ++i)
+    {
+        if (format[i] != flag_char)
+        {
+            ++span.m_length;
+            continue;
+        }
+
+        if (format_span::placeholder == span.m_type)
+        {
+            format_spec::parse(format.substr(span.m_start, span.m_length), span.m_spec);
+            dst.push_back(span);
+        }
+        else if (span.m_length > 0)
+        {
+            dst.push_back(span);
+        }
+
+        CharT ch = flag_char;
+        flag_char = next_flag_char;
+        next_flag_char = ch;
+
+        format_span::type t = span.m_type;
+        span.m_type = next_type;
+        next_type = t;
+
+        span.m_start = i + 1;
+        span.m_length = 0;
+    }
+
+    if ('}' == flag_char)
+    {
+        // Incomplete placeholder, treat it as a raw string.
+        span.m_type = format_span::raw;
+        --span.m_start;
+        ++span.m_length;
+    }
+
+    if (span.m_length > 0)
+        dst.push_back(span);
+}
+
+template <typename CharT>
+constexpr size_t count_format_spans(const string_piece<CharT> &format)
+{
+    format_span_counter counter;
+    parse_format_spans(format, counter);
+    return counter.size;
+}
+
+constexpr bool is_format_align(int ch)
+{
+    return '<' == ch || '>' == ch || '^' == ch;
+}
+
+constexpr bool is_format_type(int ch)
+{
+    switch (ch)
+    {
+        case 'b': case 'B': case 'c': case 'd': case 'o': case 'x': case 'X':
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+        case 's': case 'p':
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Argument Rendering
+ */
+
+struct format_arg {
+    const void *m_value;
+    void (*m_render)(std::string &dst, const format_spec &spec, const void *value);
+};
+
+inline void append_formatted(std::string &dst, const format_spec &spec, const string_piece<char> &prefix, const string_piece<char> &body, char default_align)
+{
+    size_t length = prefix.length() + body.length();
+    size_t padding = spec.width > length ? spec.width - length : 0;
+    if (0 == padding)
+    {
+        dst.append(prefix.data(), prefix.length()).append(body.data(), body.length());
+        return;
+    }
+
+    if (spec.zero_padding && '\0' == spec.align)
+    {
+        dst.append(prefix.data(), prefix.length()).append(padding, '0').append(body.data(), body.length());
+        return;
+    }
+
+    char align = '\0' != spec.align ? spec.align : default_align;
+    size_t left = '>' == align ? padding : ('^' == align ? padding / 2 : 0);
+    dst.append(left, spec.fill);
+    dst.append(prefix.data(), prefix.length()).append(body.data(), body.length());
+    dst.append(padding - left, spec.fill);
+}
+
+inline void append_formatted(std::string &dst, const format_spec &spec, const string_piece<char> &s)
+{
+    string_piece<char> body = spec.precision >= 0 ? s.substr(0, spec.precision) : s;
+    append_formatted(dst, spec, string_piece<char>(), body, '<');
+}
+
+template <typename T>
+void render_integer(std::string &dst, const format_spec &spec, T n)
+{
+    using promoted_type = decltype(+n);
+    using unsigned_type = std::make_unsigned_t<promoted_type>;
+
+    if ('c' == spec.type)
+    {
+        char ch = static_cast<char>(n);
+        append_formatted(dst, spec, string_piece<char>(&ch, 1));
+        return;
+    }
+
+    bool negative = false;
+    unsigned_type u = static_cast<unsigned_type>(n);
+    if constexpr (std::is_signed<promoted_type>::value)
+    {
+        if (n < 0)
+        {
+            negative = true;
+            u = 0 - u;
+        }
+    }
+
+    char buf[sizeof(unsigned_type) * 8];
+    char *end = buf + sizeof(buf), *p;
+    switch (spec.type)
+    {
+        case 'b': case 'B': p = write_radix_backward<1>(end, u); break;
+        case 'o':           p = write_radix_backward<3>(end, u); break;
+        case 'x':           p = write_radix_backward<4>(end, u); break;
+        case 'X':           p = write_radix_backward<4>(end, u, true); break;
+        default:            p = write_decimal_backward(end, u);
+    }
+
+    char prefix[3];
+    size_t prefix_length = 0;
+    if (negative)
+        prefix[prefix_length++] = '-';
+    else if ('-' != spec.sign)
+        prefix[prefix_length++] = spec.sign;
+    if (spec.alternate && 'c' != spec.type && 'd' != spec.type && '\0' != spec.type)
+    {
+        prefix[prefix_length++] = '0';
+        if ('o' != spec.type)
+            prefix[prefix_length++] = spec.type;
+    }
+
+    append_formatted(dst, spec, string_piece<char>(prefix, prefix_length), string_piece<char>(p, end - p), '>');
+}
+
+template <typename T>
+std::to_chars_result floating_point_to_chars(char *first, char *last, const format_spec &spec, T n)
+{
+    switch (spec.type)
+    {
+        case 'e': case 'E':
+            return spec.precision >= 0 ? std::to_chars(first, last, n, std::chars_format::scientific, spec.precision) : std::to_chars(first, last, n, std::chars_format::scientific);
+        case 'f': case 'F':
+            return spec.precision >= 0 ? std::to_chars(first, last, n, std::chars_format::fixed, spec.precision) : std::to_chars(first, last, n, std::chars_format::fixed);
+        case 'g': case 'G':
+            return std::to_chars(first, last, n, std::chars_format::general, spec.precision >= 0 ? spec.precision : 6);
+    }
+    return spec.precision >= 0 ? std::to_chars(first, last, n, std::chars_format::general, spec.precision) : std::to_chars(first, last, n);
+}
+
+template <typename T>
+void render_floating_point(std::string &dst, const format_spec &spec, T n)
+{
+    char buf[128];
+    std::vector<char> large_buf;
+
+    char *first = buf;
+    auto r = floating_point_to_chars(buf, buf + sizeof(buf), spec, n);
+    if (std::errc() != r.ec)
+    {
+        // Huge numbers in the fixed notation, rarely reached.
+        large_buf.resize(std::numeric_limits<T>::max_exponent10 + 32 + std::max(spec.precision, 0));
+        first = large_buf.data();
+        r = floating_point_to_chars(first, first + large_buf.size(), spec, n);
+        ZASSERT(std::errc() == r.ec);
+    }
+
+    if ('E' == spec.type || 'F' == spec.type || 'G' == spec.type)
+    {
+        for (char *p = first; p < r.ptr; ++p)
+        {
+            if (zed::islower(*p))
+                *p -= 'a' - 'A';
+        }
+    }
+
+    string_piece<char> prefix;
+    if ('-' == *first)
+        prefix = string_piece<char>(first++, 1);
+    else if ('-' != spec.sign)
+        prefix = string_piece<char>(&spec.sign, 1);
+    append_formatted(dst, spec, prefix, string_piece<char>(first, r.ptr - first), '>');
+}
+
+template <class Serializer, typename T>
+void render_arg(std::string &dst, const format_spec &spec, const T &arg)
+{
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        // Let the serializer decide how to spell it.
+        std::vector<std::string> serialized;
+        Serializer::push(serialized, arg);
+        append_formatted(dst, spec, serialized.back());
+    }
+    else if constexpr (std::is_integral<T>::value)
+    {
+        render_integer(dst, spec, arg);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
+    {
+        render_floating_point(dst, spec, arg);
+    }
+    else if constexpr (std::is_convertible<const T &, string_piece<char>>::value)
+    {
+        append_formatted(dst, spec, string_piece<char>(arg));
+    }
+    else if constexpr (std::is_pointer<T>::value)
+    {
+        number_buffer buf;
+        append_formatted(dst, spec, string_piece<char>(), format_number(buf, arg), '>');
+    }
+    else
+    {
+        std::vector<std::string> serialized;
+        Serializer::push(serialized, arg);
+        append_formatted(dst, spec, serialized.back());
+    }
+}
+
+template <class Serializer, typename T>
+void render_erased_arg(std::string &dst, const format_spec &spec, const void *value)
+{
+    render_arg<Serializer>(dst, spec, *static_cast<const T *>(value));
+}
+
+template <class Serializer, typename T>
+format_arg make_format_arg(const T &arg)
+{
+    return format_arg{ &arg, &render_erased_arg<Serializer, T> };
+}
+
+template <class Serializer, typename... Args>
+void format_to(std::string &dst, const char *ps, const format_span *spans, size_t count, const Args&... args)
+{
+    const std::array<format_arg, sizeof...(Args)> arg_list = { { make_format_arg<Serializer>(args)... } };
+
+    size_t idx = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const format_span &span = spans[i];
+        if (format_span::raw == span.m_type)
+        {
+            dst.append(ps + span.m_start, span.m_length);
+            continue;
+        }
+
+        if (idx < arg_list.size())
+            arg_list[idx].m_render(dst, span.m_spec, arg_list[idx].m_value);
+        ++idx;
+    }
+}
+
+/**
+ * Runtime Format Cache
+ *
+ * Spans of runtime format strings are cached per thread, keyed by the address of the format string.
+ * The content is verified on every hit, so a reused buffer never yields stale spans.
+ * The cache is 2-way set associative with LRU replacement, and long formats are not cached at all.
+ */
+
+class format_span_cache
+{
+    struct slot;
+public:
+    static format_span_cache& current(void);
+
+    class spans
+    {
+    public:
+        spans(spans &&o) : m_slot(std::exchange(o.m_slot, nullptr)), m_parsed(std::move(o.m_parsed)) {}
+        ~spans(void);
+
+        const format_span* data(void) const;
+        size_t size(void) const;
+
+        spans(const spans &) = delete;
+        spans& operator=(const spans &) = delete;
+    private:
+        friend class format_span_cache;
+        explicit spans(slot *s);
+        explicit spans(std::vector<format_span> &&parsed) : m_parsed(std::move(parsed)) {}
+
+        slot *m_slot = nullptr;
+        std::vector<format_span> m_parsed;
+    };
+    spans find_or_parse(const string_piece<char> &format);
+private:
+    format_span_cache(void) = default;
+
+    static constexpr size_t set_count = 32;
+    static constexpr size_t max_format_length = 1024;
+
+    struct slot {
+        const char *key = nullptr;
+        std::string format;
+        std::vector<format_span> parsed;
+        unsigned pins = 0;
+    };
+    struct set {
+        slot ways[2];
+        unsigned recent = 0;
+    };
+    static size_t set_index(const char *key);
+
+    std::array<set, set_count> m_sets;
+};
+
+template <class Serializer, typename... Args>
+void sequence_format_to(std::string &dst, const char *fmt, const Args&... args)
+{
+    string_piece<char> format(fmt);
+    format_span_cache::spans spans = format_span_cache::current().find_or_parse(format);
+
+    dst.reserve(dst.length() + format.length() + sizeof...(Args) * 16);
+    format_to<Serializer>(dst, fmt, spans.data(), spans.size(), args...);
+}
+
+inline format_span_cache& format_span_cache::current(void)
+{
+    static thread_local format_span_cache s_cache;
+    return s_cache;
+}
+
+inline format_span_cache::spans format_span_cache::find_or_parse(const string_piece<char> &format)
+{
+    std::vector<format_span> parsed;
+    if (format.length() > max_format_length)
+    {
+        parse_format_spans(format, parsed);
+        return spans(std::move(parsed));
+    }
+
+    set &s = m_sets[set_index(format.data())];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        slot &way = s.ways[i];
+        if (way.key == format.data() && strequ(way.format, format))
+        {
+            s.recent = i;
+            return spans(&way);
+        }
+    }
+
+    parse_format_spans(format, parsed);
+
+    // Slots in use by outer (re-entrant) formatting calls can't be evicted.
+    unsigned victim = 1 - s.recent;
+    if (0 != s.ways[victim].pins)
+        victim = s.recent;
+    slot &way = s.ways[victim];
+    if (0 != way.pins)
+        return spans(std::move(parsed));
+
+    way.key = format.data();
+    way.format.assign(format.data(), format.length());
+    way.parsed = std::move(parsed);
+    s.recent = victim;
+    return spans(&way);
+}
+
+inline size_t format_span_cache::set_index(const char *key)
+{
+    std::uintptr_t n = reinterpret_cast<std::uintptr_t>(key);
+    return ((n >> 4) ^ (n >> 12)) % set_count;
+}
+
+inline format_span_cache::spans::spans(slot *s) : m_slot(s)
+{
+    ++m_slot->pins;
+}
+
+inline format_span_cache::spans::~spans(void)
+{
+    if (nullptr != m_slot)
+        --m_slot->pins;
+}
+
+inline const format_span* format_span_cache::spans::data(void) const
+{
+    return nullptr != m_slot ? m_slot->parsed.data() : m_parsed.data();
+}
+
+inline size_t format_span_cache::spans::size(void) const
+{
+    return nullptr != m_slot ? m_slot->parsed.size() : m_parsed.size();
+}
+
+template <class Serializer, class Literal, typename... Args>
+void sequence_format_to(std::string &dst, const format_string<Literal> &, const Args&... args)
+{
+    using format_type = format_string<Literal>;
+    static_assert(format_type::placeholder_count() == sizeof...(Args), "Placeholders and arguments mismatch!");
+    static_assert(format_type::specs_valid(), "Invalid format specification!");
+
+    static constexpr auto spans = format_type::parse();
+    dst.reserve(dst.length() + format_type::raw_length() + sizeof...(Args) * 16);
+    format_to<Serializer>(dst, format_type::source().data(), spans.data(), spans.size(), args...);
+}
+
+} // namespace detail
+
+template <typename T>
+void default_arg_serializer::push(std::vector<std::string> &dst, const T &arg)
+{
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+        number_buffer buf;
+        string_piece<char> s = format_number(buf, arg);
+        dst.emplace_back(s.data(), s.length());
+    }
+    else
+    {
+        dst.emplace_back(std::to_string(arg));
+    }
 }
 
 template <>
@@ -98,6 +649,116 @@ void args_collector<Serializer>::collect_from(const Arg &arg, const Args&... arg
     collect_from<Args...>(args...);
 }
 
+template <typename CharT>
+constexpr bool format_spec::parse(const string_piece<CharT> &s, format_spec &dst)
+{
+    dst = format_spec();
+    if (s.empty() || ':' != s[0])
+        return true;
+
+    format_spec spec;
+    size_t i = 1, n = s.length();
+    if (i + 1 < n && detail::is_format_align(s[i + 1]))
+    {
+        spec.fill = static_cast<char>(s[i]);
+        spec.align = static_cast<char>(s[i + 1]);
+        i += 2;
+    }
+    else if (i < n && detail::is_format_align(s[i]))
+    {
+        spec.align = static_cast<char>(s[i++]);
+    }
+
+    if (i < n && ('+' == s[i] || '-' == s[i] || ' ' == s[i]))
+        spec.sign = static_cast<char>(s[i++]);
+    if (i < n && '#' == s[i])
+    {
+        spec.alternate = true;
+        ++i;
+    }
+    if (i < n && '0' == s[i])
+    {
+        spec.zero_padding = true;
+        ++i;
+    }
+    while (i < n && '0' <= s[i] && s[i] <= '9')
+    {
+        spec.width = spec.width * 10 + (s[i++] - '0');
+        if (spec.width > max_width)
+            return false;
+    }
+
+    if (i < n && '.' == s[i])
+    {
+        if (++i >= n || s[i] < '0' || '9' < s[i])
+            return false;
+        spec.precision = 0;
+        while (i < n && '0' <= s[i] && s[i] <= '9')
+        {
+            spec.precision = spec.precision * 10 + (s[i++] - '0');
+            if (spec.precision > max_precision)
+                return false;
+        }
+    }
+
+    if (i < n)
+    {
+        if (!detail::is_format_type(s[i]))
+            return false;
+        spec.type = static_cast<char>(s[i++]);
+    }
+
+    if (i != n)
+        return false;
+
+    dst = spec;
+    return true;
+}
+
+template <class Literal>
+constexpr typename format_string<Literal>::spans format_string<Literal>::parse(void)
+{
+    detail::format_span_array<std::tuple_size<spans>::value> ret;
+    detail::parse_format_spans(Literal::get(), ret);
+    return ret.spans;
+}
+
+template <class Literal>
+constexpr size_t format_string<Literal>::placeholder_count(void)
+{
+    size_t ret = 0;
+    for (const detail::format_span &span : parse())
+    {
+        if (detail::format_span::placeholder == span.m_type)
+            ++ret;
+    }
+    return ret;
+}
+
+template <class Literal>
+constexpr size_t format_string<Literal>::raw_length(void)
+{
+    size_t ret = 0;
+    for (const detail::format_span &span : parse())
+    {
+        if (detail::format_span::raw == span.m_type)
+            ret += span.m_length;
+    }
+    return ret;
+}
+
+template <class Literal>
+constexpr bool format_string<Literal>::specs_valid(void)
+{
+    for (const detail::format_span &span : parse())
+    {
+        format_spec spec;
+        if (detail::format_span::placeholder == span.m_type && !format_spec::parse(source().substr(span.m_start, span.m_length), spec))
+            return false;
+    }
+    return true;
+}
+
 template <typename CharT>
 template <typename S>
 formatter_impl<CharT>::formatter_impl(const S &format)
@@ -139,22 +800,52 @@ formatter_impl<CharT>::formatter_impl(const S &format)
 template <typename CharT>
 std::basic_string<CharT> formatter_impl<CharT>::format(const part_formatter &formatter) const
 {
+    size_t estimate = 0;
+    for (const part &p : m_parts)
+        estimate += p.m_type == part::raw ? p.m_content.length() : 16;
+
+    // Results are built in place, and only moved to a builder once they grow large.
     std::basic_string<CharT> ret;
+    ret.reserve(estimate);
+    basic_string_builder<CharT> large;
+    auto append = [&ret, &large](const std::basic_string<CharT> &s) {
+        if (large.empty() && ret.length() + s.length() < basic_string_builder<CharT>::min_worthwhile_size)
+        {
+            ret.append(s);
+            return;
+        }
+        if (large.empty())
+        {
+            large.append(ret);
+            ret.clear();
+        }
+        large.append(s);
+    };
+
     for (const part &p : m_parts)
     {
         if (p.m_type == part::raw)
-            ret.append(p.m_content);
+            append(p.m_content);
         else
-            ret.append(formatter(p.m_content));
+            append(formatter(p.m_content));
     }
-    return ret;
+    return large.empty() ? ret : large.str();
 }
 
 template <typename... Args>
 std::string sequence_format(const char *fmt, const Args&... args)
 {
-    args_collector ac;
-    return detail::sequence_format(ac, fmt, args...);
+    std::string ret;
+    detail::sequence_format_to<default_arg_serializer>(ret, fmt, args...);
+    return ret;
+}
+
+template <class Literal, typename... Args>
+std::string sequence_format(const format_string<Literal> &fmt, const Args&... args)
+{
+    std::string ret;
+    detail::sequence_format_to<default_arg_serializer>(ret, fmt, args...);
+    return ret;
 }
 
 } // namespace zed
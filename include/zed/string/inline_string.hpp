@@ -0,0 +1,242 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: inline_string.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_STRING_INLINE_STRING_HPP
+#define ZED_STRING_INLINE_STRING_HPP
+
+#include <cstdint>
+#include <functional>
+#include "../string.hpp"
+
+namespace zed {
+
+/**
+ * Inline Strings
+ *
+ * Up to N chars are stored inside the object along with a length byte, so short keys (header
+ * names, ini keys, query keys, ...) never allocate, e.g. `inline_string<31>` takes 32 bytes.
+ * Strings are not NUL-terminated, use them as `string_piece`s.
+ *
+ * What happens to longer strings depends on the spill policy:
+ */
+
+enum class inline_spill {
+    reject,   // Assignments fail and leave the string unchanged, constructors assert.
+    truncate, // Strings are cut to N chars.
+    heap      // Strings are copied to the heap, which makes the type not trivially copyable.
+};
+
+template <typename CharT, size_t N, inline_spill Spill = inline_spill::reject>
+class basic_inline_string;
+
+template <size_t N, inline_spill Spill = inline_spill::reject>
+using inline_string = basic_inline_string<char, N, Spill>;
+
+namespace detail {
+
+template <typename CharT, size_t N, bool Heap>
+class inline_storage;
+
+} // namespace detail
+
+template <typename CharT, size_t N, inline_spill Spill>
+class basic_inline_string : public detail::inline_storage<CharT, N, inline_spill::heap == Spill>
+{
+    using storage = detail::inline_storage<CharT, N, inline_spill::heap == Spill>;
+public:
+    using value_type = CharT;
+    using const_iterator = const CharT *;
+    static constexpr size_t capacity = N;
+
+    basic_inline_string(void) = default;
+    basic_inline_string(const CharT *psz) : basic_inline_string(string_piece<CharT>(psz, std::char_traits<CharT>::length(psz))) {}
+    basic_inline_string(const string_piece<CharT> &s);
+    basic_inline_string(const std::basic_string<CharT> &s) : basic_inline_string(string_piece<CharT>(s.data(), s.length())) {}
+
+    // Returns false if `s` is longer than N, which is always accepted by `inline_spill::heap`.
+    bool assign(const string_piece<CharT> &s);
+    void clear(void) { storage::set(nullptr, 0); }
+
+    using storage::data;
+    using storage::length;
+    size_t size(void) const { return length(); }
+    bool empty(void) const { return 0 == length(); }
+
+    const_iterator begin(void) const { return data(); }
+    const_iterator end(void) const { return data() + length(); }
+
+    operator string_piece<CharT>() const { return string_piece<CharT>(data(), length()); }
+
+    bool operator==(const basic_inline_string &o) const;
+    bool operator!=(const basic_inline_string &o) const { return !(*this == o); }
+    bool operator<(const basic_inline_string &o) const { return zed::strcmp(*this, o) < 0; }
+};
+
+template <typename CharT, size_t N, inline_spill Spill>
+struct chartype_trait<basic_inline_string<CharT, N, Spill>> { using char_type = CharT; };
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+template <typename CharT, size_t N>
+class inline_storage<CharT, N, false>
+{
+    static_assert(0 < N && N < UINT8_MAX, "Inline strings are limited to 254 chars!");
+public:
+    const CharT* data(void) const { return m_chars; }
+    size_t length(void) const { return m_length; }
+protected:
+    void set(const CharT *s, size_t length)
+    {
+        ZASSERT(length <= N);
+        std::char_traits<CharT>::move(m_chars, s, length);
+        m_length = static_cast<std::uint8_t>(length);
+    }
+private:
+    CharT m_chars[N];
+    std::uint8_t m_length = 0;
+};
+
+template <typename CharT, size_t N>
+class inline_storage<CharT, N, true>
+{
+    static_assert(0 < N && N < UINT8_MAX, "Inline strings are limited to 254 chars!");
+    static_assert(N * sizeof(CharT) >= sizeof(CharT *), "Too small to hold a spilled string!");
+public:
+    inline_storage(void) = default;
+    inline_storage(const inline_storage &o) { set(o.data(), o.length()); }
+    inline_storage(inline_storage &&o) noexcept
+    {
+        take(o);
+    }
+    ~inline_storage(void) { release(); }
+
+    inline_storage& operator=(const inline_storage &o)
+    {
+        if (this != &o)
+            set(o.data(), o.length());
+        return *this;
+    }
+    inline_storage& operator=(inline_storage &&o) noexcept
+    {
+        if (this != &o)
+        {
+            release();
+            take(o);
+        }
+        return *this;
+    }
+
+    const CharT* data(void) const { return spilled() ? m_heap->chars : m_chars; }
+    size_t length(void) const { return spilled() ? m_heap->length : m_length; }
+protected:
+    void set(const CharT *s, size_t length)
+    {
+        // `s` may point into this string.
+        heap_block *old = spilled() ? m_heap : nullptr;
+        if (length <= N)
+        {
+            std::char_traits<CharT>::move(m_chars, s, length);
+            m_length = static_cast<std::uint8_t>(length);
+        }
+        else
+        {
+            heap_block *b = static_cast<heap_block *>(::operator new(sizeof(heap_block) + length * sizeof(CharT)));
+            b->length = length;
+            std::char_traits<CharT>::copy(b->chars, s, length);
+            m_heap = b;
+            m_length = spilled_tag;
+        }
+        if (nullptr != old && old != m_heap)
+            ::operator delete(old);
+    }
+private:
+    struct heap_block {
+        size_t length;
+        CharT chars[1];
+    };
+    static constexpr std::uint8_t spilled_tag = UINT8_MAX;
+
+    bool spilled(void) const { return spilled_tag == m_length; }
+    void take(inline_storage &o)
+    {
+        std::memcpy(m_chars, o.m_chars, sizeof(m_chars)); // Copies the heap pointer as well.
+        m_length = o.m_length;
+        o.m_length = 0;
+    }
+    void release(void)
+    {
+        if (spilled())
+            ::operator delete(m_heap);
+    }
+
+    union {
+        CharT m_chars[N];
+        heap_block *m_heap;
+    };
+    std::uint8_t m_length = 0;
+};
+
+} // namespace detail
+
+template <typename CharT, size_t N, inline_spill Spill>
+basic_inline_string<CharT, N, Spill>::basic_inline_string(const string_piece<CharT> &s)
+{
+    bool assigned = assign(s);
+    ZASSERT(assigned || inline_spill::reject != Spill);
+    (void)assigned;
+}
+
+template <typename CharT, size_t N, inline_spill Spill>
+bool basic_inline_string<CharT, N, Spill>::assign(const string_piece<CharT> &s)
+{
+    if constexpr (inline_spill::heap != Spill)
+    {
+        if (s.length() > N)
+        {
+            if constexpr (inline_spill::truncate == Spill)
+                storage::set(s.data(), N);
+            return false;
+        }
+    }
+    storage::set(s.data(), s.length());
+    return true;
+}
+
+template <typename CharT, size_t N, inline_spill Spill>
+bool basic_inline_string<CharT, N, Spill>::operator==(const basic_inline_string &o) const
+{
+    return length() == o.length() && 0 == std::char_traits<CharT>::compare(data(), o.data(), length());
+}
+
+} // namespace zed
+
+namespace std {
+template <typename CharT, size_t N, zed::inline_spill Spill>
+struct hash<zed::basic_inline_string<CharT, N, Spill>>
+{
+    size_t operator()(const zed::basic_inline_string<CharT, N, Spill> &s) const
+    {
+#ifdef _Z_STRING_VIEW_ENABLED
+        return hash<basic_string_view<CharT>>()(basic_string_view<CharT>(s.data(), s.length()));
+#else
+        size_t ret = 14695981039346656037ull;
+        for (CharT ch : s)
+            ret = (ret ^ static_cast<size_t>(ch)) * 1099511628211ull;
+        return ret;
+#endif
+    }
+};
+} // namespace std
+
+#endif // ZED_STRING_INLINE_STRING_HPP
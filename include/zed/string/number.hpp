@@ -0,0 +1,160 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: number.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_STRING_NUMBER_HPP
+#define ZED_STRING_NUMBER_HPP
+
+#include <charconv>
+#include <cstdint>
+#include "../string.hpp"
+
+namespace zed {
+
+/**
+ * Number Serialization
+ *
+ * Numbers are written into caller-provided buffers (usually on the stack),
+ * no allocations and no locales are involved.
+ * Floating-point numbers are written in the shortest form which round-trips.
+ */
+
+constexpr size_t number_buffer_size = 32;
+using number_buffer = char[number_buffer_size];
+
+template <typename T>
+string_piece<char> format_number(number_buffer &buf, T n);
+
+template <typename T>
+string_piece<char> format_number(number_buffer &buf, T *p);
+
+template <typename T>
+void append_number(std::string &dst, T n);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+constexpr char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+template <typename U>
+char* write_decimal_backward(char *end, U u)
+{
+    while (u >= 100)
+    {
+        const char *pair = digit_pairs + (u % 100) * 2;
+        u /= 100;
+        end -= 2;
+        end[0] = pair[0];
+        end[1] = pair[1];
+    }
+
+    if (u >= 10)
+    {
+        const char *pair = digit_pairs + u * 2;
+        end -= 2;
+        end[0] = pair[0];
+        end[1] = pair[1];
+    }
+    else
+    {
+        *--end = static_cast<char>('0' + u);
+    }
+    return end;
+}
+
+template <unsigned Bits, typename U>
+char* write_radix_backward(char *end, U u, bool upper_case = false)
+{
+    constexpr U mask = (1U << Bits) - 1;
+    const char *digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[u & mask];
+        u >>= Bits;
+    } while (0 != u);
+    return end;
+}
+
+template <typename T>
+string_piece<char> format_integer(number_buffer &buf, T n)
+{
+    using promoted_type = decltype(+n);
+    using unsigned_type = std::make_unsigned_t<promoted_type>;
+
+    char *end = buf + number_buffer_size;
+    unsigned_type u = static_cast<unsigned_type>(n);
+    if constexpr (std::is_signed<promoted_type>::value)
+    {
+        if (n < 0)
+        {
+            char *p = write_decimal_backward(end, static_cast<unsigned_type>(0 - u));
+            *--p = '-';
+            return string_piece<char>(p, end - p);
+        }
+    }
+
+    char *p = write_decimal_backward(end, u);
+    return string_piece<char>(p, end - p);
+}
+
+template <typename T>
+string_piece<char> format_floating_point(number_buffer &buf, T n)
+{
+    auto r = std::to_chars(buf, buf + number_buffer_size, n);
+    ZASSERT(std::errc() == r.ec);
+    return string_piece<char>(buf, r.ptr - buf);
+}
+
+} // namespace detail
+
+template <typename T>
+string_piece<char> format_number(number_buffer &buf, T n)
+{
+    static_assert(std::is_arithmetic<T>::value, "Not a number!");
+    if constexpr (std::is_same<T, bool>::value)
+        return detail::format_integer(buf, static_cast<unsigned>(n));
+    else if constexpr (std::is_integral<T>::value)
+        return detail::format_integer(buf, n);
+    else
+        return detail::format_floating_point(buf, n);
+}
+
+template <typename T>
+string_piece<char> format_number(number_buffer &buf, T *p)
+{
+    char *end = buf + number_buffer_size;
+    char *ps = detail::write_radix_backward<4>(end, reinterpret_cast<std::uintptr_t>(p));
+    *--ps = 'x';
+    *--ps = '0';
+    return string_piece<char>(ps, end - ps);
+}
+
+template <typename T>
+void append_number(std::string &dst, T n)
+{
+    number_buffer buf;
+    string_piece<char> s = format_number(buf, n);
+    dst.append(s.data(), s.length());
+}
+
+} // namespace zed
+
+#endif // ZED_STRING_NUMBER_HPP
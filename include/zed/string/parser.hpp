@@ -13,23 +13,152 @@
 #define ZED_STRING_PARSER_HPP
 
 #include <cstdio>
+#include <utility>
 #include "../ctype.hpp"
+#include "../string.hpp"
 
 namespace zed {
 
+namespace detail {
+
+inline const char* find_first_in_range(const char *p, const char *end, const char_set &set)
+{
+    size_t n = zed::find_first_of(string_piece<char>(p, end - p), set);
+    return string_piece<char>::npos != n ? p + n : end;
+}
+
+inline const char* find_first_not_in_range(const char *p, const char *end, const char_set &set)
+{
+    size_t n = zed::find_first_not_of(string_piece<char>(p, end - p), set);
+    return string_piece<char>::npos != n ? p + n : end;
+}
+
+inline const char* find_first_not_in_psz(const char *p, const char_set &set)
+{
+    while ('\0' != *p && set.contains(*p))
+        ++p;
+    return p;
+}
+
+} // namespace detail
+
+/**
+ * Parser Streams
+ *
+ * `basic_parser_stream` takes its input from a source policy, so parsers templated on the stream
+ * inline every char access down to pointer operations. Sources expose their input as a window of
+ * contiguous chars, which is the whole input for in-memory sources:
+ *
+ *   const char* begin(void) const;                                           // of the window
+ *   bool at_window_end(const char *p) const;
+ *   int char_at(const char *p) const;                                        // EOF at the end
+ *   const char* find_first_of(const char *p, const char_set &set) const;     // or the window end
+ *   const char* find_first_not_of(const char *p, const char_set &set) const; // or the window end
+ *   size_t offset_of(const char *p) const;                                   // in the whole input
+ *
+ *   // Reads more input, chars from `keep` on are kept in the window and both pointers are
+ *   // updated. Returns false if there is no more input.
+ *   bool refill(const char *&keep, const char *&p);
+ *
+ * Spans returned by the stream are valid until the next call to it.
+ *
+ * `parser_stream` is the virtual base class of the same operations over contiguous chars, for
+ * callers which cannot be templates. Subclasses implement `current_char` and `advance_internal` on
+ * `m_current`, and may override the scan hooks, which walk char by char by default.
+ * `parser_psz_stream` and `parser_string_stream` override them with vectorized searches.
+ */
+
+template <class Source>
+class basic_parser_stream
+{
+public:
+    template <typename... Args>
+    explicit basic_parser_stream(Args&&... args);
+
+    int current_char(void) const { return m_source.char_at(m_current); }
+    int peek(const char_set &chars_to_skip = ascii_whitespace<char>::set);
+    int peek(const char *chars_to_skip) { return peek(char_set(chars_to_skip)); }
+
+    int advance(void);
+
+    // Moves to the first char in `stop_chars` (or the end), returns that char.
+    int skip_until(const char_set &stop_chars);
+    int skip_until(const char *stop_chars) { return skip_until(char_set(stop_chars)); }
+    // Same as `skip_until`, but returns the chars skipped.
+    string_piece<char> take_until(const char_set &stop_chars);
+    string_piece<char> take_until(const char *stop_chars) { return take_until(char_set(stop_chars)); }
+    // Moves past chars in `chars`, returns the chars skipped.
+    string_piece<char> skip_while(const char_set &chars);
+
+    size_t parsed_count(void) const { return m_source.offset_of(m_current); }
+    const Source& source(void) const { return m_source; }
+private:
+    template <typename Find>
+    string_piece<char> take(const Find &find);
+    template <typename Find>
+    void skip(const Find &find);
+
+    Source m_source;
+    const char *m_current;
+};
+
+class parser_psz_source
+{
+public:
+    explicit parser_psz_source(const char *psz) : m_psz(psz) {}
+
+    const char* begin(void) const { return m_psz; }
+    bool at_window_end(const char *p) const { return '\0' == *p; }
+    int char_at(const char *p) const { return '\0' != *p ? *p : EOF; }
+    const char* find_first_of(const char *p, const char_set &set) const { return detail::find_first_in_psz(p, set); }
+    const char* find_first_not_of(const char *p, const char_set &set) const { return detail::find_first_not_in_psz(p, set); }
+    size_t offset_of(const char *p) const { return p - m_psz; }
+    bool refill(const char *&, const char *&) { return false; }
+private:
+    const char *m_psz;
+};
+
+class parser_string_source
+{
+public:
+    template <class String>
+    explicit parser_string_source(const String &s) : m_start(s.data()), m_end(s.data() + s.length()) {}
+
+    const char* begin(void) const { return m_start; }
+    bool at_window_end(const char *p) const { return p == m_end; }
+    int char_at(const char *p) const { return p < m_end ? *p : EOF; }
+    const char* find_first_of(const char *p, const char_set &set) const;
+    const char* find_first_not_of(const char *p, const char_set &set) const;
+    size_t offset_of(const char *p) const { return p - m_start; }
+    bool refill(const char *&, const char *&) { return false; }
+private:
+    const char *m_start, *m_end;
+};
+
 class parser_stream
 {
 public:
     virtual ~parser_stream(void) = default;
 
     virtual int current_char(void) const = 0;
-    int peek(const char *chars_to_skip = ascii_whitespace<char>::chars);
+    int peek(const char *chars_to_skip = ascii_whitespace<char>::chars) { return peek(char_set(chars_to_skip)); }
+    int peek(const char_set &chars_to_skip);
 
     int advance(void);
 
+    int skip_until(const char_set &stop_chars);
+    int skip_until(const char *stop_chars) { return skip_until(char_set(stop_chars)); }
+    string_piece<char> take_until(const char_set &stop_chars);
+    string_piece<char> take_until(const char *stop_chars) { return take_until(char_set(stop_chars)); }
+    string_piece<char> skip_while(const char_set &chars);
+
     size_t parsed_count(void) const { return m_current - m_start; }
 protected:
-    parser_stream(const char *start) : m_start(start), m_current(start) {}
+    parser_stream(const char *start) : m_current(start), m_start(start) {}
+
+    // Move `m_current` to the first char in (or not in) `set`, or to the end.
+    virtual void skip_to_first_of(const char_set &set);
+    virtual void skip_to_first_not_of(const char_set &set);
 
     const char *m_current;
 private:
@@ -44,6 +173,8 @@ public:
     explicit parser_psz_stream(const char *psz) : parser_stream(psz) {}
 private:
     int current_char(void) const override;
+    void skip_to_first_of(const char_set &set) override { m_current = detail::find_first_in_psz(m_current, set); }
+    void skip_to_first_not_of(const char_set &set) override { m_current = detail::find_first_not_in_psz(m_current, set); }
     void advance_internal(void) override;
 };
 
@@ -54,6 +185,8 @@ public:
     explicit parser_string_stream(const String &s) : parser_stream(s.data()), m_end(s.data() + s.length()) {}
 private:
     int current_char(void) const override { return m_current < m_end ? *m_current : EOF; }
+    void skip_to_first_of(const char_set &set) override { m_current = detail::find_first_in_range(m_current, m_end, set); }
+    void skip_to_first_not_of(const char_set &set) override { m_current = detail::find_first_not_in_range(m_current, m_end, set); }
     void advance_internal(void) override;
 
     const char *m_end;
@@ -62,29 +195,78 @@ private:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Implementations
 
-inline int parser_stream::advance(void)
+template <class Source>
+template <typename... Args>
+basic_parser_stream<Source>::basic_parser_stream(Args&&... args) : m_source(std::forward<Args>(args)...), m_current(m_source.begin())
+{
+    if (m_source.at_window_end(m_current))
+        m_source.refill(m_current, m_current);
+}
+
+template <class Source>
+int basic_parser_stream<Source>::advance(void)
 {
     int ch = current_char();
     if (EOF != ch)
     {
-        advance_internal();
+        ++m_current;
+        if (m_source.at_window_end(m_current))
+            m_source.refill(m_current, m_current);
         ch = current_char();
     }
     return ch;
 }
 
-inline int parser_stream::peek(const char *chars_to_skip)
+template <class Source>
+int basic_parser_stream<Source>::peek(const char_set &chars_to_skip)
 {
     int ch = current_char();
-    while (EOF != ch && nullptr != strchr(chars_to_skip, ch))
-        ch = advance();
+    if (EOF != ch && chars_to_skip.contains(static_cast<char>(ch)))
+    {
+        skip([this, &chars_to_skip](const char *p) { return m_source.find_first_not_of(p, chars_to_skip); });
+        ch = current_char();
+    }
     return ch;
 }
 
-inline int parser_psz_stream::current_char(void) const
+template <class Source>
+template <typename Find>
+void basic_parser_stream<Source>::skip(const Find &find)
 {
-    char ch = *m_current;
-    return '\0' != ch ? ch : EOF;
+    do {
+        m_current = find(m_current);
+    } while (m_source.at_window_end(m_current) && m_source.refill(m_current, m_current));
+}
+
+template <class Source>
+string_piece<char> basic_parser_stream<Source>::skip_while(const char_set &chars)
+{
+    return take([this, &chars](const char *p) { return m_source.find_first_not_of(p, chars); });
+}
+
+template <class Source>
+int basic_parser_stream<Source>::skip_until(const char_set &stop_chars)
+{
+    skip([this, &stop_chars](const char *p) { return m_source.find_first_of(p, stop_chars); });
+    return current_char();
+}
+
+template <class Source>
+template <typename Find>
+string_piece<char> basic_parser_stream<Source>::take(const Find &find)
+{
+    // Chars taken are kept in the window while refilling, so tokens may straddle refills.
+    const char *start = m_current;
+    do {
+        m_current = find(m_current);
+    } while (m_source.at_window_end(m_current) && m_source.refill(start, m_current));
+    return string_piece<char>(start, m_current - start);
+}
+
+template <class Source>
+string_piece<char> basic_parser_stream<Source>::take_until(const char_set &stop_chars)
+{
+    return take([this, &stop_chars](const char *p) { return m_source.find_first_of(p, stop_chars); });
 }
 
 inline void parser_psz_stream::advance_internal(void)
@@ -93,6 +275,74 @@ inline void parser_psz_stream::advance_internal(void)
     ++m_current;
 }
 
+inline int parser_psz_stream::current_char(void) const
+{
+    char ch = *m_current;
+    return '\0' != ch ? ch : EOF;
+}
+
+
+inline int parser_stream::advance(void)
+{
+    int ch = current_char();
+    if (EOF != ch)
+    {
+        advance_internal();
+        ch = current_char();
+    }
+    return ch;
+}
+
+inline int parser_stream::peek(const char_set &chars_to_skip)
+{
+    skip_to_first_not_of(chars_to_skip);
+    return current_char();
+}
+
+inline string_piece<char> parser_stream::skip_while(const char_set &chars)
+{
+    const char *start = m_current;
+    skip_to_first_not_of(chars);
+    return string_piece<char>(start, m_current - start);
+}
+
+inline void parser_stream::skip_to_first_not_of(const char_set &set)
+{
+    int ch = current_char();
+    while (EOF != ch && set.contains(static_cast<char>(ch)))
+        ch = advance();
+}
+
+inline void parser_stream::skip_to_first_of(const char_set &set)
+{
+    int ch = current_char();
+    while (EOF != ch && !set.contains(static_cast<char>(ch)))
+        ch = advance();
+}
+
+inline int parser_stream::skip_until(const char_set &stop_chars)
+{
+    skip_to_first_of(stop_chars);
+    return current_char();
+}
+
+inline string_piece<char> parser_stream::take_until(const char_set &stop_chars)
+{
+    const char *start = m_current;
+    skip_to_first_of(stop_chars);
+    return string_piece<char>(start, m_current - start);
+}
+
+inline const char* parser_string_source::find_first_of(const char *p, const char_set &set) const
+{
+    return detail::find_first_in_range(p, m_end, set);
+}
+
+inline const char* parser_string_source::find_first_not_of(const char *p, const char_set &set) const
+{
+    return detail::find_first_not_in_range(p, m_end, set);
+}
+
 inline void parser_string_stream::advance_internal(void)
 {
     ZASSERT(m_current < m_end);
@@ -0,0 +1,295 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: replacer.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_STRING_REPLACER_HPP
+#define ZED_STRING_REPLACER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include "../string.hpp"
+
+namespace zed {
+
+/**
+ * Multi-pattern Replacing
+ *
+ * Patterns are compiled into an Aho-Corasick automaton once, then each source is scanned in a
+ * single pass no matter how many patterns there are. Matches never overlap: the leftmost one
+ * wins, and the longest one among those starting at the same position.
+ * The output length is known before anything is written, so the result is allocated only once.
+ *
+ * multi_replacer<char> escaper({ { "&", "&amp;" }, { "<", "&lt;" }, { ">", "&gt;" } });
+ * std::string html = escaper.replace(text);
+ */
+
+template <typename CharT>
+class multi_replacer
+{
+public:
+    using piece_type = string_piece<CharT>;
+    using string_type = std::basic_string<CharT>;
+    using rule = std::pair<piece_type, piece_type>; // pattern -> replacement
+
+    // Empty patterns are ignored, for duplicated patterns the first rule wins.
+    multi_replacer(std::initializer_list<rule> rules) : multi_replacer(rules.begin(), rules.end()) {}
+    template <class Iterator>
+    multi_replacer(Iterator first, Iterator last);
+
+    string_type replace(const piece_type &src) const;
+    // Appends the result to `dst`.
+    void replace(const piece_type &src, string_type &dst) const;
+private:
+    using state_type = std::uint32_t;
+    static constexpr state_type no_state = static_cast<state_type>(-1);
+
+    struct match
+    {
+        size_t start;
+        size_t rule;
+    };
+
+    void add_pattern(size_t rule, const piece_type &pattern);
+    void build(void);
+
+    size_t char_class(CharT ch) const;
+    state_type next_state(state_type s, CharT ch) const { return m_transitions[s * m_class_count + char_class(ch)]; }
+    size_t skip_to_start_char(const piece_type &src, size_t pos) const;
+    // Returns the length of the result.
+    size_t find_matches(const piece_type &src, std::vector<match> &matches) const;
+
+    std::vector<string_type> m_patterns, m_replacements;
+
+    // Chars used by patterns are mapped to classes 1...N, all other chars go to class 0.
+    std::vector<CharT> m_alphabet;
+    std::uint16_t m_byte_classes[256] = { 0 };
+    size_t m_class_count = 1;
+    string_type m_start_chars;
+
+    std::vector<state_type> m_transitions;
+    std::vector<std::uint32_t> m_depths;
+    std::vector<std::uint32_t> m_outputs; // Longest rule ending at each state, plus 1.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+template <typename CharT>
+template <class Iterator>
+multi_replacer<CharT>::multi_replacer(Iterator first, Iterator last)
+{
+    for (Iterator it = first; it != last; ++it)
+    {
+        piece_type pattern(it->first), replacement(it->second);
+        if (pattern.empty())
+            continue;
+
+        m_patterns.emplace_back(pattern.data(), pattern.length());
+        m_replacements.emplace_back(replacement.data(), replacement.length());
+        for (CharT ch : pattern)
+            m_alphabet.push_back(ch);
+        m_start_chars.push_back(pattern.front());
+    }
+
+    std::sort(m_alphabet.begin(), m_alphabet.end());
+    m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+    m_class_count = m_alphabet.size() + 1;
+    if constexpr (1 == sizeof(CharT))
+    {
+        for (size_t i = 0; i < m_alphabet.size(); ++i)
+            m_byte_classes[static_cast<unsigned char>(m_alphabet[i])] = static_cast<std::uint16_t>(i + 1);
+    }
+
+    std::sort(m_start_chars.begin(), m_start_chars.end());
+    m_start_chars.erase(std::unique(m_start_chars.begin(), m_start_chars.end()), m_start_chars.end());
+
+    m_transitions.assign(m_class_count, no_state);
+    m_depths.push_back(0);
+    m_outputs.push_back(0);
+    for (size_t i = 0; i < m_patterns.size(); ++i)
+        add_pattern(i, m_patterns[i]);
+    build();
+}
+
+template <typename CharT>
+void multi_replacer<CharT>::add_pattern(size_t rule, const piece_type &pattern)
+{
+    state_type s = 0;
+    for (CharT ch : pattern)
+    {
+        state_type &t = m_transitions[s * m_class_count + char_class(ch)];
+        if (no_state == t)
+        {
+            t = static_cast<state_type>(m_depths.size());
+            m_transitions.resize(m_transitions.size() + m_class_count, no_state);
+            m_depths.push_back(m_depths[s] + 1);
+            m_outputs.push_back(0);
+        }
+        s = m_transitions[s * m_class_count + char_class(ch)];
+    }
+
+    if (0 == m_outputs[s])
+        m_outputs[s] = static_cast<std::uint32_t>(rule + 1);
+}
+
+template <typename CharT>
+void multi_replacer<CharT>::build(void)
+{
+    // Breadth-first, so failure states are always complete before they are referred.
+    std::vector<state_type> failures(m_depths.size(), 0), queue;
+    queue.reserve(m_depths.size());
+    for (size_t c = 0; c < m_class_count; ++c)
+    {
+        state_type &t = m_transitions[c];
+        if (no_state == t)
+            t = 0;
+        else
+            queue.push_back(t);
+    }
+
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        state_type s = queue[i];
+        state_type f = failures[s];
+        if (0 == m_outputs[s])
+            m_outputs[s] = m_outputs[f];
+
+        for (size_t c = 0; c < m_class_count; ++c)
+        {
+            state_type &t = m_transitions[s * m_class_count + c];
+            state_type ft = m_transitions[f * m_class_count + c];
+            if (no_state == t)
+            {
+                t = ft;
+            }
+            else
+            {
+                failures[t] = ft;
+                queue.push_back(t);
+            }
+        }
+    }
+}
+
+template <typename CharT>
+size_t multi_replacer<CharT>::char_class(CharT ch) const
+{
+    if constexpr (1 == sizeof(CharT))
+    {
+        return m_byte_classes[static_cast<unsigned char>(ch)];
+    }
+    else
+    {
+        auto it = std::lower_bound(m_alphabet.begin(), m_alphabet.end(), ch);
+        return m_alphabet.end() != it && *it == ch ? it - m_alphabet.begin() + 1 : 0;
+    }
+}
+
+template <typename CharT>
+size_t multi_replacer<CharT>::skip_to_start_char(const piece_type &src, size_t pos) const
+{
+    if constexpr (std::is_same<CharT, char>::value)
+    {
+        if (m_start_chars.length() <= detail::max_simd_char_set)
+        {
+            size_t p = find_first_of(src, piece_type(m_start_chars), pos);
+            return piece_type::npos != p ? p : src.length();
+        }
+    }
+    return pos;
+}
+
+template <typename CharT>
+size_t multi_replacer<CharT>::find_matches(const piece_type &src, std::vector<match> &matches) const
+{
+    const size_t n = src.length();
+    size_t ret = n;
+
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t best_start = piece_type::npos, best_rule = 0;
+
+        state_type s = 0;
+        for (size_t j = i; j < n; ++j)
+        {
+            if (0 == s && piece_type::npos == best_start)
+            {
+                j = skip_to_start_char(src, j);
+                if (j >= n)
+                    break;
+            }
+
+            s = next_state(s, src[j]);
+
+            // Any match found from now on starts at `j + 1 - depth` or later.
+            if (j + 1 - m_depths[s] > best_start)
+                break;
+
+            if (0 != m_outputs[s])
+            {
+                size_t rule = m_outputs[s] - 1;
+                size_t start = j + 1 - m_patterns[rule].length();
+                if (start <= best_start)
+                {
+                    best_start = start;
+                    best_rule = rule;
+                }
+            }
+        }
+
+        if (piece_type::npos == best_start)
+            break;
+
+        matches.push_back({ best_start, best_rule });
+        ret = ret - m_patterns[best_rule].length() + m_replacements[best_rule].length();
+        i = best_start + m_patterns[best_rule].length();
+    }
+    return ret;
+}
+
+template <typename CharT>
+std::basic_string<CharT> multi_replacer<CharT>::replace(const piece_type &src) const
+{
+    string_type ret;
+    replace(src, ret);
+    return ret;
+}
+
+template <typename CharT>
+void multi_replacer<CharT>::replace(const piece_type &src, string_type &dst) const
+{
+    std::vector<match> matches;
+    size_t length = find_matches(src, matches);
+
+    size_t offset = dst.length();
+    dst.resize(offset + length);
+
+    using traits = std::char_traits<CharT>;
+    CharT *p = dst.data() + offset;
+    size_t b = 0;
+    for (const match &m : matches)
+    {
+        const string_type &replacement = m_replacements[m.rule];
+        traits::copy(p, src.data() + b, m.start - b);
+        p += m.start - b;
+        traits::copy(p, replacement.data(), replacement.length());
+        p += replacement.length();
+        b = m.start + m_patterns[m.rule].length();
+    }
+    traits::copy(p, src.data() + b, src.length() - b);
+}
+
+} // namespace zed
+
+#endif // ZED_STRING_REPLACER_HPP
@@ -0,0 +1,418 @@
+#pragma once
+// -------------------------------------------------
+// ZED Kit
+// -------------------------------------------------
+//   File Name: utf8.hpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+#ifndef ZED_STRING_UTF8_HPP
+#define ZED_STRING_UTF8_HPP
+
+#include "../string.hpp"
+
+namespace zed {
+
+/**
+ * UTF-8 Validation
+ *
+ * With SSSE3/AVX2, 64 bytes are checked per step by the lookup-table algorithm of Keiser & Lemire
+ * (the one simdutf uses): three 16-entry tables indexed by the nibbles of each byte and its
+ * predecessor classify every error in a handful of shuffles, and pure ASCII blocks are skipped
+ * after a single movemask. Elsewhere a scalar decoder runs, skipping ASCII 8 bytes at a time.
+ */
+
+bool validate_utf8(const string_piece<char> &s);
+// Returns the offset of the first ill-formed sequence, or npos if `s` is well-formed.
+size_t find_invalid_utf8(const string_piece<char> &s);
+
+// Replaces each maximal ill-formed subsequence with U+FFFD, returns false if `s` is already well-formed.
+bool repair_utf8(std::string *s);
+std::string repair_utf8(const string_piece<char> &s);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+namespace detail {
+
+constexpr char32_t replacement_char = 0xfffd;
+
+// `*i` points to the lead byte of a non-ASCII sequence, and is moved past the sequence (or its maximal ill-formed subpart).
+inline char32_t decode_utf8(const unsigned char *s, size_t length, size_t *i)
+{
+    unsigned char lead = s[(*i)++];
+
+    size_t trailing;
+    char32_t cp;
+    unsigned char lo = 0x80, hi = 0xbf; // Range of the 2nd byte, which excludes overlongs and surrogates.
+    if (0xc2 <= lead && lead <= 0xdf)
+    {
+        trailing = 1;
+        cp = lead & 0x1f;
+    }
+    else if (0xe0 <= lead && lead <= 0xef)
+    {
+        trailing = 2;
+        cp = lead & 0x0f;
+        if (0xe0 == lead)
+            lo = 0xa0;
+        else if (0xed == lead)
+            hi = 0x9f;
+    }
+    else if (0xf0 <= lead && lead <= 0xf4)
+    {
+        trailing = 3;
+        cp = lead & 0x07;
+        if (0xf0 == lead)
+            lo = 0x90;
+        else if (0xf4 == lead)
+            hi = 0x8f;
+    }
+    else
+    {
+        return replacement_char;
+    }
+
+    for (; trailing > 0; --trailing)
+    {
+        if (*i >= length || s[*i] < lo || s[*i] > hi)
+            return replacement_char;
+        cp = (cp << 6) | (s[(*i)++] & 0x3f);
+        lo = 0x80; hi = 0xbf;
+    }
+    return cp;
+}
+
+inline size_t encode_utf8(char32_t cp, char *dst)
+{
+    if (cp < 0x80)
+    {
+        dst[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        dst[0] = static_cast<char>(0xc0 | (cp >> 6));
+        dst[1] = static_cast<char>(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        dst[0] = static_cast<char>(0xe0 | (cp >> 12));
+        dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        dst[2] = static_cast<char>(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xf0 | (cp >> 18));
+    dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    dst[3] = static_cast<char>(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+inline size_t find_invalid_utf8_scalar(const unsigned char *s, size_t length, size_t i)
+{
+    while (i < length)
+    {
+        if (s[i] < 0x80)
+        {
+            for (; i + 8 <= length; i += 8)
+            {
+                std::uint64_t w;
+                std::memcpy(&w, s + i, sizeof(w));
+                if (0 != (w & 0x8080808080808080ull))
+                    break;
+            }
+            while (i < length && s[i] < 0x80)
+                ++i;
+            continue;
+        }
+
+        size_t start = i;
+        // A well-formed U+FFFD is the only 3-byte sequence decoded into the replacement char.
+        if (replacement_char == decode_utf8(s, length, &i) && (3 != i - start || 0xef != s[start]))
+            return start;
+    }
+    return string_piece<char>::npos;
+}
+
+// Moves `i` back to the lead byte of a sequence running across it, if any.
+inline size_t utf8_sequence_start(const unsigned char *s, size_t i)
+{
+    for (size_t k = 1; k <= 3 && k <= i; ++k)
+    {
+        unsigned char ch = s[i - k];
+        if (ch < 0x80)
+            break;
+        if (ch >= 0xc0)
+            return i - k;
+    }
+    return i;
+}
+
+#ifdef _Z_SIMD_SSSE3
+/**
+ * Each table maps a nibble to the set of errors it may take part in, an error happens only if
+ * all three nibbles (high and low of the previous byte, high of the current one) agree on it.
+ */
+namespace utf8_lookup {
+
+enum : std::uint8_t {
+    too_short   = 1 << 0, // 11______ 0_______, 11______ 11______
+    too_long    = 1 << 1, // 0_______ 10______
+    overlong_3  = 1 << 2, // 11100000 100_____
+    too_large   = 1 << 3, // 11110100 1001____, 11110100 101_____, 11110101+ 10______
+    surrogate   = 1 << 4, // 11101101 101_____
+    overlong_2  = 1 << 5, // 1100000_ 10______
+    too_large_1000 = 1 << 6, // 11110101+ 1000____
+    overlong_4  = 1 << 6, // 11110000 1000____
+    two_conts   = 1 << 7, // 10______ 10______, unless it is the 3rd/4th byte of a sequence
+    carry       = too_short | too_long | two_conts
+};
+
+alignas(16) constexpr std::uint8_t byte_1_high[16] = {
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    two_conts, two_conts, two_conts, two_conts,
+    too_short | overlong_2,
+    too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4
+};
+
+alignas(16) constexpr std::uint8_t byte_1_low[16] = {
+    carry | overlong_3 | overlong_2 | overlong_4,
+    carry | overlong_2,
+    carry,
+    carry,
+    carry | too_large,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000
+};
+
+alignas(16) constexpr std::uint8_t byte_2_high[16] = {
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_short, too_short, too_short, too_short
+};
+
+// The last 3 bytes of a block, which are incomplete sequences if they exceed these.
+alignas(16) constexpr std::uint8_t incomplete_bounds[16] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xf0 - 1, 0xe0 - 1, 0xc0 - 1
+};
+
+} // namespace utf8_lookup
+
+#   ifdef _Z_SIMD_AVX2
+inline __m256i load_utf8_table(const std::uint8_t *table)
+{
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table)));
+}
+
+inline __m256i utf8_block_errors(__m256i input, __m256i prev_input)
+{
+    const __m256i byte_1_high = load_utf8_table(utf8_lookup::byte_1_high);
+    const __m256i byte_1_low = load_utf8_table(utf8_lookup::byte_1_low);
+    const __m256i byte_2_high = load_utf8_table(utf8_lookup::byte_2_high);
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+
+    __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+    __m256i errors = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble)),
+            _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, low_nibble))),
+        _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble)));
+
+    // The 3rd and 4th bytes of sequences must be the continuations flagged as `two_conts`.
+    __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    __m256i must_be_cont = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(errors, must_be_cont);
+}
+
+inline __m256i utf8_incomplete(__m256i input)
+{
+    const __m256i bounds = _mm256_inserti128_si256(_mm256_set1_epi8(static_cast<char>(0xff)),
+        _mm_load_si128(reinterpret_cast<const __m128i *>(utf8_lookup::incomplete_bounds)), 1);
+    return _mm256_subs_epu8(input, bounds);
+}
+#   else
+inline __m128i load_utf8_table(const std::uint8_t *table)
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(table));
+}
+
+inline __m128i utf8_block_errors(__m128i input, __m128i prev_input)
+{
+    const __m128i byte_1_high = load_utf8_table(utf8_lookup::byte_1_high);
+    const __m128i byte_1_low = load_utf8_table(utf8_lookup::byte_1_low);
+    const __m128i byte_2_high = load_utf8_table(utf8_lookup::byte_2_high);
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+
+    __m128i errors = _mm_and_si128(
+        _mm_and_si128(
+            _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble)),
+            _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, low_nibble))),
+        _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble)));
+
+    // The 3rd and 4th bytes of sequences must be the continuations flagged as `two_conts`.
+    __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80)));
+    __m128i must_be_cont = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(errors, must_be_cont);
+}
+
+inline __m128i utf8_incomplete(__m128i input)
+{
+    return _mm_subs_epu8(input, load_utf8_table(utf8_lookup::incomplete_bounds));
+}
+#   endif
+#endif // _Z_SIMD_SSSE3
+
+inline size_t find_invalid_utf8(const unsigned char *s, size_t length)
+{
+    size_t i = 0;
+#if defined(_Z_SIMD_AVX2)
+    __m256i prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256();
+    for (; i + 64 <= length; i += 64)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i + 32));
+
+        __m256i errors;
+        if (0 == _mm256_movemask_epi8(_mm256_or_si256(a, b)))
+        {
+            errors = incomplete;
+            incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            errors = _mm256_or_si256(utf8_block_errors(a, prev), utf8_block_errors(b, a));
+            incomplete = utf8_incomplete(b);
+        }
+        prev = b;
+
+        // Errors are located by the scalar decoder, from the sequence running into this step.
+        if (!_mm256_testz_si256(errors, errors))
+            break;
+    }
+#elif defined(_Z_SIMD_SSSE3)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i prev = zero, incomplete = zero;
+    for (; i + 64 <= length; i += 64)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(s + i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2), d = _mm_loadu_si128(p + 3);
+
+        __m128i errors;
+        if (0 == _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+        {
+            errors = incomplete;
+            incomplete = zero;
+        }
+        else
+        {
+            errors = _mm_or_si128(
+                _mm_or_si128(utf8_block_errors(a, prev), utf8_block_errors(b, a)),
+                _mm_or_si128(utf8_block_errors(c, b), utf8_block_errors(d, c)));
+            incomplete = utf8_incomplete(d);
+        }
+        prev = d;
+
+        // Errors are located by the scalar decoder, from the sequence running into this step.
+        if (0xffff != _mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)))
+            break;
+    }
+#endif
+    return find_invalid_utf8_scalar(s, length, utf8_sequence_start(s, i));
+}
+
+inline void repair_utf8(const string_piece<char> &s, size_t first_invalid, std::string &dst)
+{
+    const unsigned char *u = reinterpret_cast<const unsigned char *>(s.data());
+    const size_t length = s.length();
+
+    size_t i = 0, p = first_invalid;
+    for (;;)
+    {
+        dst.append(s.data() + i, p - i);
+        if (p == length)
+            break;
+
+        i = p;
+        decode_utf8(u, length, &i);
+        dst.append("\xef\xbf\xbd", 3);
+
+        size_t n = find_invalid_utf8(u + i, length - i);
+        p = string_piece<char>::npos != n ? i + n : length;
+    }
+}
+
+} // namespace detail
+
+inline size_t find_invalid_utf8(const string_piece<char> &s)
+{
+    return detail::find_invalid_utf8(reinterpret_cast<const unsigned char *>(s.data()), s.length());
+}
+
+inline bool validate_utf8(const string_piece<char> &s)
+{
+    return string_piece<char>::npos == find_invalid_utf8(s);
+}
+
+inline bool repair_utf8(std::string *s)
+{
+    size_t p = find_invalid_utf8(*s);
+    if (string_piece<char>::npos == p)
+        return false;
+
+    std::string repaired;
+    repaired.reserve(s->length() + 2);
+    detail::repair_utf8(*s, p, repaired);
+    s->swap(repaired);
+    return true;
+}
+
+inline std::string repair_utf8(const string_piece<char> &s)
+{
+    std::string ret;
+    size_t p = find_invalid_utf8(s);
+    if (string_piece<char>::npos == p)
+    {
+        ret.assign(s.data(), s.length());
+    }
+    else
+    {
+        ret.reserve(s.length() + 2);
+        detail::repair_utf8(s, p, ret);
+    }
+    return ret;
+}
+
+} // namespace zed
+
+#endif // ZED_STRING_UTF8_HPP
@@ -13,9 +13,17 @@
 #define ZED_THREAD_HPP
 
 #include "./platform_sdk.h"
-#ifdef _Z_OS_WINDOWS
+#if defined(_Z_OS_WINDOWS)
 #   include "./string/conv.hpp"
 #   include "./win/hmodule.hpp"
+#elif defined(_Z_OS_POSIX)
+#   include <cstdint>
+#   include <cstring>
+#   include <pthread.h>
+#   include <unistd.h>
+#   ifdef _Z_OS_LINUX
+#       include <sys/syscall.h>
+#   endif
 #endif
 
 namespace zed {
@@ -38,11 +46,19 @@ private:
 #if defined(_Z_OS_WINDOWS)
     static DWORD WINAPI callback(PVOID arg);
     HANDLE m_handle;
+#elif defined(_Z_OS_POSIX)
+    static void* callback(void *arg);
+    pthread_t m_handle;
+    bool m_joined = false;
 #endif
 };
 
 #if defined(_Z_OS_WINDOWS)
 using thread_id_t = DWORD;
+#elif defined(_Z_OS_LINUX)
+using thread_id_t = pid_t;
+#elif defined(_Z_OS_POSIX)
+using thread_id_t = std::uint64_t;
 #endif
 
 class current_thread
@@ -67,6 +83,9 @@ thread<T>::thread(T *p, worker pfn)
     , m_handle(::CreateThread(nullptr, 0, callback, this, 0, nullptr))
 #endif
 {
+#ifdef _Z_OS_POSIX
+    ::pthread_create(&m_handle, nullptr, callback, this);
+#endif
 }
 
 #ifdef _Z_OS_WINDOWS
@@ -111,7 +130,8 @@ inline bool current_thread::set_description(const char *description)
         HRESULT (WINAPI * pfn)(HANDLE, PCWSTR);
         if (hmodule::get_proc_address(kernel32, "SetThreadDescription", pfn))
         {
-            std::wstring ws = multi_byte_to_wide_string(description);
+            std::wstring ws;
+            utf8_to_utf16(description, ws);
             HRESULT hr = pfn(::GetCurrentThread(), ws.c_str());
             if (SUCCEEDED(hr))
                 return true;
@@ -141,6 +161,56 @@ inline void current_thread::set_name_for_debugger(const char *name)
 }
 #endif // _Z_OS_WINDOWS
 
+#ifdef _Z_OS_POSIX
+template <class T>
+thread<T>::~thread(void)
+{
+    if (!m_joined)
+        ::pthread_detach(m_handle);
+}
+
+template <class T>
+void* thread<T>::callback(void *arg)
+{
+    reinterpret_cast<thread<T> *>(arg)->work();
+    return nullptr;
+}
+
+template <class T>
+void thread<T>::join(void)
+{
+    if (!m_joined)
+    {
+        ::pthread_join(m_handle, nullptr);
+        m_joined = true;
+    }
+}
+
+inline thread_id_t current_thread::id(void)
+{
+#ifdef _Z_OS_LINUX
+    return static_cast<pid_t>(::syscall(SYS_gettid));
+#else
+    std::uint64_t ret = 0;
+    ::pthread_threadid_np(nullptr, &ret);
+    return ret;
+#endif
+}
+
+inline void current_thread::set_name(const char *name)
+{
+#ifdef _Z_OS_LINUX
+    // Names are limited to 15 chars.
+    char buf[16];
+    std::strncpy(buf, name, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    ::pthread_setname_np(::pthread_self(), buf);
+#else
+    ::pthread_setname_np(name);
+#endif
+}
+#endif // _Z_OS_POSIX
+
 } // namespace zed
 
 #endif // ZED_THREAD_HPP
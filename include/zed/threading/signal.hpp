@@ -33,6 +33,65 @@ public:
 };
 #endif // _Z_OS_WINDOWS
 
+#ifdef _Z_OS_POSIX
+// Manual-reset, the same as Windows events.
+class signal
+{
+public:
+    signal(void);
+    ~signal(void);
+
+    signal(const signal &) = delete;
+    signal& operator=(const signal &) = delete;
+
+    void reset(void);
+    void notify(void);
+    void wait(void);
+private:
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_cond;
+    bool m_notified = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementations
+
+inline signal::signal(void)
+{
+    ::pthread_mutex_init(&m_mutex, nullptr);
+    ::pthread_cond_init(&m_cond, nullptr);
+}
+
+inline signal::~signal(void)
+{
+    ::pthread_cond_destroy(&m_cond);
+    ::pthread_mutex_destroy(&m_mutex);
+}
+
+inline void signal::notify(void)
+{
+    ::pthread_mutex_lock(&m_mutex);
+    m_notified = true;
+    ::pthread_cond_broadcast(&m_cond);
+    ::pthread_mutex_unlock(&m_mutex);
+}
+
+inline void signal::reset(void)
+{
+    ::pthread_mutex_lock(&m_mutex);
+    m_notified = false;
+    ::pthread_mutex_unlock(&m_mutex);
+}
+
+inline void signal::wait(void)
+{
+    ::pthread_mutex_lock(&m_mutex);
+    while (!m_notified)
+        ::pthread_cond_wait(&m_cond, &m_mutex);
+    ::pthread_mutex_unlock(&m_mutex);
+}
+#endif // _Z_OS_POSIX
+
 } // namespace zed
 
 #endif // ZED_THREADING_SIGNAL_HPP
@@ -39,7 +39,7 @@ private:
     queue_t m_tasks;
 };
 
-class task_thread : public thread<task_thread>
+class task_thread
 {
 public:
     task_thread(void);
@@ -60,6 +60,7 @@ private:
 
     bool m_running = true;
     task_queue<task> m_queue;
+    thread<task_thread> m_thread; // Last, so the loop starts with the queue constructed.
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -105,18 +106,21 @@ void task_queue<task_t>::take(queue_t &dst)
 {
     m_signal.wait();
     if (auto _ = m_mutex.guard())
+    {
+        // Reset with the lock held, or tasks added right after the swap would be left unsignaled.
+        m_signal.reset();
         m_tasks.swap(dst);
-    m_signal.reset();
+    }
 }
 
-inline task_thread::task_thread(void) : thread(this, &task_thread::work)
+inline task_thread::task_thread(void) : m_thread(this, &task_thread::work)
 {
 }
 
 inline task_thread::~task_thread(void)
 {
     add(new detail::exit_loop_task(m_running));
-    join();
+    m_thread.join();
 }
 
 inline void task_thread::loop(void)
@@ -445,13 +445,17 @@ inline void sqlite_stmt::get_column_text<char>(int zero_based_index, std::string
 template <>
 inline void sqlite_stmt::get_column_text<wchar_t>(int zero_based_index, std::wstring &dst)
 {
-    dst = get_column_text16(zero_based_index);
+    const char *ps = reinterpret_cast<const char *>(::sqlite3_column_text(get(), zero_based_index));
+    int l = ::sqlite3_column_bytes(get(), zero_based_index);
+    dst.clear();
+    utf8_to_utf16(string_piece<char>(ps, l), dst);
 }
 
 inline std::wstring sqlite_stmt::get_column_text16(int zero_based_index)
 {
-    std::string text = get_column_text(zero_based_index);
-    return multi_byte_to_wide_string(text, CP_UTF8);
+    std::wstring ret;
+    get_column_text<wchar_t>(zero_based_index, ret);
+    return ret;
 }
 #endif
 
@@ -0,0 +1,570 @@
+// -------------------------------------------------
+// ZED Kit - Benchmarks
+// -------------------------------------------------
+//   File Name: benchmarks.cpp
+//      Author: Ziming Li
+//     Created: 2026-10-18
+// -------------------------------------------------
+// Copyright (C) 2026 MingYang Software Technology.
+// -------------------------------------------------
+
+// Benchmarks are disabled by default, run them with:
+//   test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <gtest/gtest.h>
+#include "zed/file/file.hpp"
+#include "zed/net/http_codecs.hpp"
+#include "zed/parsers/ini.hpp"
+#include "zed/parsers/ini_schema.hpp"
+#include "zed/parsers/ini_view.hpp"
+#include "zed/string/algorithm.hpp"
+#include "zed/string/conv.hpp"
+#include "zed/string/inline_string.hpp"
+#include "zed/string/replacer.hpp"
+#include "zed/string/utf8.hpp"
+
+namespace {
+
+template <typename F>
+double measure_ns(size_t iterations, const F &f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        f(i);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void report(const char *name, double ns, const char *unit = "op")
+{
+    printf("  %-40s %8.2f ns/%s\n", name, ns, unit);
+}
+
+// Request header names weighted roughly by how often they show up in real traffic.
+const std::vector<std::string>& header_name_samples(void)
+{
+    static std::vector<std::string> s_samples;
+    if (!s_samples.empty())
+        return s_samples;
+
+    const std::pair<const char *, int> weighted_names[] = {
+        { "Host", 100 }, { "User-Agent", 98 }, { "Accept", 95 }, { "Accept-Encoding", 90 },
+        { "Accept-Language", 85 }, { "Connection", 80 }, { "Cookie", 60 }, { "Referer", 55 },
+        { "Content-Type", 40 }, { "Content-Length", 40 }, { "Cache-Control", 35 }, { "If-None-Match", 20 },
+        { "If-Modified-Since", 15 }, { "Upgrade-Insecure-Requests", 30 }, { "Sec-Fetch-Mode", 25 },
+        { "Sec-Fetch-Site", 25 }, { "Sec-Fetch-Dest", 25 }, { "Sec-Ch-Ua-Platform", 20 }, { "Origin", 18 },
+        { "Authorization", 10 }, { "X-Forwarded-For", 12 }, { "X-Requested-With", 8 }, { "DNT", 5 }, { "TE", 3 }
+    };
+
+    std::mt19937 rng(20261018);
+    for (const auto &[name, weight] : weighted_names)
+    {
+        for (int i = 0; i < weight; ++i)
+        {
+            std::string s(name);
+            switch (rng() % 3)
+            {
+                case 0: // As is.
+                    break;
+                case 1: // HTTP/2 style.
+                    for (char &ch : s)
+                        ch = zed::fold_ascii_case(ch);
+                    break;
+                default:
+                    for (char &ch : s)
+                    {
+                        if (zed::islower(ch))
+                            ch -= 'a' - 'A';
+                    }
+            }
+            s_samples.push_back(s);
+        }
+    }
+    std::shuffle(s_samples.begin(), s_samples.end(), rng);
+    return s_samples;
+}
+
+int naive_stricmp(const std::string &s1, const std::string &s2)
+{
+    size_t n = std::min(s1.length(), s2.length());
+    for (size_t i = 0; i < n; ++i)
+    {
+        int c1 = std::tolower(s1[i]), c2 = std::tolower(s2[i]);
+        if (c1 != c2)
+            return c1 > c2 ? 1 : -1;
+    }
+    return s1.length() == s2.length() ? 0 : (s1.length() > s2.length() ? 1 : -1);
+}
+
+} // namespace
+
+TEST(StringComparisons, DISABLED_BenchmarkHeaderNames)
+{
+    const std::vector<std::string> &samples = header_name_samples();
+    const char *wanted[] = { "content-length", "accept-language", "cookie", "sec-fetch-site" };
+    constexpr size_t iterations = 4000000;
+
+    volatile size_t hits = 0;
+    report("naive tolower loop", measure_ns(iterations, [&](size_t i) {
+        hits += 0 == naive_stricmp(samples[i % samples.size()], wanted[i & 3]);
+    }));
+    report("striequ(std::string, const char *)", measure_ns(iterations, [&](size_t i) {
+        hits += zed::striequ(samples[i % samples.size()], wanted[i & 3]);
+    }));
+    report("striequ(const char *, const char *)", measure_ns(iterations, [&](size_t i) {
+        hits += zed::striequ(samples[i % samples.size()].c_str(), wanted[i & 3]);
+    }));
+    report("stricmp(std::string, std::string)", measure_ns(iterations, [&](size_t i) {
+        hits += 0 == zed::stricmp(samples[i % samples.size()], samples[(i * 7) % samples.size()]);
+    }));
+    report("strequ(std::string, const char *)", measure_ns(iterations, [&](size_t i) {
+        hits += zed::strequ(samples[i % samples.size()], wanted[i & 3]);
+    }));
+}
+
+TEST(StringSearching, DISABLED_BenchmarkLogPayloads)
+{
+    // A few MBs of log lines, split as our log pipeline does.
+    std::string payload;
+    std::mt19937 rng(20261018);
+    while (payload.length() < 4 * 1024 * 1024)
+    {
+        payload.append("2026-10-18 12:00:00.000 [worker-").append(std::to_string(rng() % 16)).append("] ");
+        payload.append(40 + rng() % 120, 'a' + rng() % 26).append("\r\n");
+    }
+    const std::string_view s(payload);
+    constexpr size_t iterations = 20;
+
+    volatile size_t hits = 0;
+    report("std::string_view::find(\"\\r\\n\")", measure_ns(iterations, [&](size_t) {
+        for (size_t p = 0; (p = s.find("\r\n", p)) != std::string_view::npos; p += 2)
+            ++hits;
+    }) / (payload.length() / 1024), "KB");
+    report("zed::find_string(\"\\r\\n\")", measure_ns(iterations, [&](size_t) {
+        for (size_t p = 0; (p = zed::find_string(s, std::string_view("\r\n"), p)) != std::string_view::npos; p += 2)
+            ++hits;
+    }) / (payload.length() / 1024), "KB");
+    report("zed::split_view(\"\\r\\n\")", measure_ns(iterations, [&](size_t) {
+        for (const auto &line : zed::split_view(s, "\r\n"))
+            hits += line.length();
+    }) / (payload.length() / 1024), "KB");
+    report("std::string_view::find(\"[worker-9]\")", measure_ns(iterations, [&](size_t) {
+        for (size_t p = 0; (p = s.find("[worker-9]", p)) != std::string_view::npos; ++p)
+            ++hits;
+    }) / (payload.length() / 1024), "KB");
+    report("zed::find_string(\"[worker-9]\")", measure_ns(iterations, [&](size_t) {
+        for (size_t p = 0; (p = zed::find_string(s, std::string_view("[worker-9]"), p)) != std::string_view::npos; ++p)
+            ++hits;
+    }) / (payload.length() / 1024), "KB");
+
+    // The first char shows up everywhere.
+    const std::string runs(payload.length(), 'a');
+    report("std::string_view::find(\"aaaab\")", measure_ns(iterations, [&](size_t) {
+        hits += std::string_view(runs).find("aaaab");
+    }) / (runs.length() / 1024), "KB");
+    report("zed::find_string(\"aaaab\")", measure_ns(iterations, [&](size_t) {
+        hits += zed::find_string(std::string_view(runs), std::string_view("aaaab"));
+    }) / (runs.length() / 1024), "KB");
+}
+
+TEST(StringReplacing, DISABLED_BenchmarkTemplateExpansion)
+{
+    // A template with 30 variables, expanded by chained `replace` calls or by a single replacer.
+    std::vector<std::pair<std::string, std::string>> variables;
+    for (int i = 0; i < 30; ++i)
+        variables.emplace_back("{{var" + std::to_string(i) + "}}", "value #" + std::to_string(i * 7919));
+
+    std::string page;
+    std::mt19937 rng(20261018);
+    while (page.length() < 64 * 1024)
+    {
+        page.append("<div class=\"item\">").append(20 + rng() % 200, 'x');
+        page.append(variables[rng() % variables.size()].first).append("</div>\n");
+    }
+
+    std::vector<std::pair<zed::string_piece<char>, zed::string_piece<char>>> rules;
+    for (const auto &[pattern, replacement] : variables)
+        rules.emplace_back(pattern, replacement);
+    zed::multi_replacer<char> replacer(rules.begin(), rules.end());
+
+    constexpr size_t iterations = 200;
+    volatile size_t length = 0;
+    report("chained zed::replace", measure_ns(iterations, [&](size_t) {
+        std::string s = page;
+        for (const auto &[pattern, replacement] : variables)
+            s = zed::replace(s, replacement, pattern);
+        length += s.length();
+    }) / (page.length() / 1024), "KB");
+    report("zed::multi_replacer", measure_ns(iterations, [&](size_t) {
+        length += replacer.replace(page).length();
+    }) / (page.length() / 1024), "KB");
+
+    zed::multi_replacer<char> escaper({ { "&", "&amp;" }, { "<", "&lt;" }, { ">", "&gt;" }, { "\"", "&quot;" }, { "'", "&#39;" } });
+    report("chained zed::replace (HTML escaping)", measure_ns(iterations, [&](size_t) {
+        std::string s = zed::replace(page, "&amp;", "&");
+        s = zed::replace(s, "&lt;", "<");
+        s = zed::replace(s, "&gt;", ">");
+        s = zed::replace(s, "&quot;", "\"");
+        s = zed::replace(s, "&#39;", "'");
+        length += s.length();
+    }) / (page.length() / 1024), "KB");
+    report("zed::multi_replacer (HTML escaping)", measure_ns(iterations, [&](size_t) {
+        length += escaper.replace(page).length();
+    }) / (page.length() / 1024), "KB");
+}
+
+TEST(StringTrimming, DISABLED_BenchmarkTrimming)
+{
+    std::vector<std::string> samples;
+    std::mt19937 rng(20261018);
+    for (int i = 0; i < 1024; ++i)
+    {
+        // Mostly a space or two, sometimes long indentation.
+        size_t leading = 0 == rng() % 8 ? rng() % 64 : rng() % 3;
+        size_t trailing = 0 == rng() % 8 ? rng() % 64 : rng() % 3;
+        samples.push_back(std::string(leading, ' ') + "text/html; charset=utf-8" + std::string(trailing, '\t'));
+    }
+
+    constexpr size_t iterations = 4000000;
+    volatile size_t length = 0;
+    report("std::string::find_first/last_not_of", measure_ns(iterations, [&](size_t i) {
+        const std::string &s = samples[i & 1023];
+        size_t b = s.find_first_not_of(zed::ascii_whitespace<char>::chars);
+        length += s.find_last_not_of(zed::ascii_whitespace<char>::chars) - b;
+    }));
+    report("zed::trim(std::string_view)", measure_ns(iterations, [&](size_t i) {
+        length += zed::trim(std::string_view(samples[i & 1023])).length();
+    }));
+    report("zed::trim(const char *)", measure_ns(iterations, [&](size_t i) {
+        length += zed::trim(samples[i & 1023].c_str()).length();
+    }));
+}
+
+TEST(CaseConversions, DISABLED_BenchmarkLowerCasing)
+{
+    const std::vector<std::string> &samples = header_name_samples();
+    constexpr size_t iterations = 4000000;
+
+    volatile size_t length = 0;
+    report("std::tolower loop", measure_ns(iterations, [&](size_t i) {
+        std::string s = samples[i % samples.size()];
+        for (char &ch : s)
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        length += s.length();
+    }));
+    report("zed::to_lower_ascii (in place)", measure_ns(iterations, [&](size_t i) {
+        std::string s = samples[i % samples.size()];
+        zed::to_lower_ascii(&s);
+        length += s.length();
+    }));
+
+    const std::string page(64 * 1024, 'X');
+    std::string dst(page.length(), '\0');
+    report("zed::to_lower_ascii (64 KB)", measure_ns(2000, [&](size_t) {
+        zed::to_lower_ascii(dst.data(), page.data(), page.length());
+        length += dst[0];
+    }) / 64, "KB");
+    report("zed::all_ascii (64 KB)", measure_ns(2000, [&](size_t) {
+        length += zed::all_ascii(page);
+    }) / 64, "KB");
+}
+
+TEST(UnicodeConversions, DISABLED_BenchmarkUTF8ToUTF16)
+{
+    std::string ascii, mixed;
+    std::mt19937 rng(20261018);
+    while (ascii.length() < 1024 * 1024)
+    {
+        ascii.append("2026-10-18 12:00:00.000 [worker] request handled in ").append(std::to_string(rng() % 1000)).append(" ms\n");
+        mixed.append("2026-10-18 12:00:00.000 [\xE5\xB7\xA5\xE4\xBD\x9C\xE7\xBA\xBF\xE7\xA8\x8B] \xE8\xAF\xB7\xE6\xB1\x82 ").append(std::to_string(rng() % 1000)).append(" ms\n");
+    }
+
+    constexpr size_t iterations = 50;
+    std::u16string dst;
+    std::string back;
+    report("zed::utf8_to_utf16 (ASCII)", measure_ns(iterations, [&](size_t) {
+        dst.clear();
+        zed::utf8_to_utf16(ascii, dst);
+    }) / (ascii.length() / 1024), "KB");
+    report("zed::utf8_to_utf16 (mixed)", measure_ns(iterations, [&](size_t) {
+        dst.clear();
+        zed::utf8_to_utf16(mixed, dst);
+    }) / (mixed.length() / 1024), "KB");
+    report("zed::utf16_to_utf8 (mixed)", measure_ns(iterations, [&](size_t) {
+        back.clear();
+        zed::utf16_to_utf8(zed::string_piece<char16_t>(dst), back);
+    }) / (mixed.length() / 1024), "KB");
+}
+
+TEST(UTF8Validation, DISABLED_BenchmarkValidation)
+{
+    std::string ascii, mixed;
+    std::mt19937 rng(20261018);
+    while (ascii.length() < 1024 * 1024)
+    {
+        ascii.append("GET /search?q=").append(std::to_string(rng())).append("&lang=en HTTP/1.1\n");
+        mixed.append("GET /search?q=\xE6\x90\x9C\xE7\xB4\xA2").append(std::to_string(rng())).append("&lang=\xC3\xA9\xF0\x9F\x98\x80 HTTP/1.1\n");
+    }
+
+    constexpr size_t iterations = 200;
+    size_t valid = 0;
+    for (const std::string *s : { &ascii, &mixed })
+    {
+        const char *kind = s == &ascii ? "(ASCII)" : "(mixed)";
+        report((std::string("zed::validate_utf8 ") + kind).c_str(), measure_ns(iterations, [&](size_t) {
+            valid += zed::validate_utf8(*s);
+        }) / (s->length() / 1024), "KB");
+        report((std::string("scalar decoder ") + kind).c_str(), measure_ns(iterations, [&](size_t) {
+            valid += zed::string_piece<char>::npos == zed::detail::find_invalid_utf8_scalar(reinterpret_cast<const unsigned char *>(s->data()), s->length(), 0);
+        }) / (s->length() / 1024), "KB");
+    }
+    ASSERT_EQ(valid, 4 * iterations);
+}
+
+TEST(InlineStrings, DISABLED_BenchmarkMapKeys)
+{
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 1000; ++i)
+        keys.push_back("x-request-header-" + std::to_string(100000 + i)); // 23 chars
+
+    constexpr size_t iterations = 200;
+    size_t found = 0;
+    report("std::string keys", measure_ns(iterations, [&](size_t) {
+        std::unordered_map<std::string, size_t> map;
+        for (size_t i = 0; i < keys.size(); ++i)
+            map.emplace(keys[i], i);
+        for (const std::string &k : keys)
+            found += map.count(k.c_str());
+    }) / keys.size(), "key");
+    report("zed::inline_string<31> keys", measure_ns(iterations, [&](size_t) {
+        std::unordered_map<zed::inline_string<31>, size_t> map;
+        for (size_t i = 0; i < keys.size(); ++i)
+            map.emplace(keys[i], i);
+        for (const std::string &k : keys)
+            found += map.count(k.c_str());
+    }) / keys.size(), "key");
+    ASSERT_EQ(found, 2 * iterations * keys.size());
+}
+
+TEST(StringBuilders, DISABLED_BenchmarkURIEncoding)
+{
+    std::string payload;
+    std::mt19937 rng(20261018);
+    while (payload.length() < 1024 * 1024)
+        payload.append("name=").append(std::to_string(rng())).append(" & path=/usr/local/").append(std::to_string(rng() % 100)).append("; ");
+
+    // The previous implementation, growing a std::string by push_back.
+    auto naive_encode = [](const std::string &s) {
+        constexpr char hex_digits[] = "0123456789ABCDEF";
+        std::string ret;
+        for (char ch : s)
+        {
+            if (zed::isalnum(ch) || nullptr != strchr("-_.!~*'()", ch))
+            {
+                ret.push_back(ch);
+            }
+            else if (' ' == ch)
+            {
+                ret.push_back('+');
+            }
+            else
+            {
+                unsigned char b = static_cast<unsigned char>(ch);
+                ret.push_back('%');
+                ret.push_back(hex_digits[b >> 4]);
+                ret.push_back(hex_digits[b & 0xf]);
+            }
+        }
+        return ret;
+    };
+
+    constexpr size_t iterations = 20;
+    size_t length = 0;
+    report("push_back into std::string", measure_ns(iterations, [&](size_t) {
+        length += naive_encode(payload).length();
+    }) / (payload.length() / 1024), "KB");
+    report("zed::encode_uri_component", measure_ns(iterations, [&](size_t) {
+        length -= zed::encode_uri_component(payload).length();
+    }) / (payload.length() / 1024), "KB");
+    ASSERT_EQ(length, 0);
+}
+
+TEST(INIParsing, DISABLED_BenchmarkParsing)
+{
+    std::string ini;
+    for (size_t i = 0; ini.length() < 1024 * 1024; ++i)
+    {
+        ini.append("[section").append(std::to_string(i)).append("]\n");
+        for (size_t j = 0; j < 16; ++j)
+            ini.append("key").append(std::to_string(j)).append(" = value ").append(std::to_string(i * j)).append(" ; comment\n");
+    }
+
+    constexpr size_t iterations = 10;
+    size_t sections = 0;
+    report("zed::ini_data::parse_stream (virtual)", measure_ns(iterations, [&](size_t) {
+        zed::parser_string_stream stream(ini);
+        sections += nullptr != zed::ini_data::parse_stream(stream).get_section("section0");
+    }) / (ini.length() / 1024), "KB");
+    report("zed::ini_data::parse_string", measure_ns(iterations, [&](size_t) {
+        sections += nullptr != zed::ini_data::parse_string(ini).get_section("section0");
+    }) / (ini.length() / 1024), "KB");
+    ASSERT_EQ(sections, 2 * iterations);
+}
+
+TEST(FrozenINIData, DISABLED_BenchmarkLookups)
+{
+    std::string ini;
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        ini.append("[section").append(std::to_string(i)).append("]\n");
+        for (size_t j = 0; j < 64; ++j)
+        {
+            ini.append("key").append(std::to_string(j)).append(" = ").append(std::to_string(i * j)).append("\n");
+            keys.emplace_back("section" + std::to_string(i), "key" + std::to_string(j));
+        }
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(20261018));
+
+    zed::ini_data data = zed::ini_data::parse_string(ini);
+    zed::frozen_ini_data frozen = data.freeze();
+
+    constexpr size_t iterations = 1000000;
+    long long sum = 0;
+    report("zed::ini_data::get_int", measure_ns(iterations, [&](size_t i) {
+        const auto &[sec, key] = keys[i % keys.size()];
+        sum += data.get_int(sec.c_str(), key.c_str(), 0);
+    }));
+    report("zed::frozen_ini_data::get_int", measure_ns(iterations, [&](size_t i) {
+        const auto &[sec, key] = keys[i % keys.size()];
+        sum -= frozen.get_int(sec, key, 0);
+    }));
+    ASSERT_EQ(sum, 0);
+}
+
+TEST(INISchemas, DISABLED_BenchmarkConfigReads)
+{
+    struct config {
+        int port = 0;
+        int workers = 0;
+    };
+    zed::ini_data data = zed::ini_data::parse_cstr("[server]\nport = 8080\nworkers = 16\n");
+
+    zed::ini_schema<config> schema;
+    schema.bind("server", "port", &config::port, 80).bind("server", "workers", &config::workers, 1);
+    config c;
+    ASSERT_TRUE(schema.apply(data, c));
+
+    constexpr size_t iterations = 1000000;
+    long long sum = 0;
+    report("zed::ini_data::get_int", measure_ns(iterations, [&](size_t) {
+        sum += data.get_int("server", "port", 80) + data.get_int("server", "workers", 1);
+    }), "2 reads");
+    report("bound struct", measure_ns(iterations, [&](size_t) {
+        const volatile config &v = c;
+        sum -= v.port + v.workers;
+    }), "2 reads");
+    ASSERT_EQ(sum, 0);
+}
+
+#ifdef _Z_OS_POSIX
+TEST(Files, DISABLED_BenchmarkSmallReads)
+{
+    constexpr size_t files = 256, file_size = 2048;
+
+    char dir[] = "/tmp/zed_file_bench_XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < files; ++i)
+    {
+        paths.push_back(std::string(dir) + "/" + std::to_string(i) + ".txt");
+        ASSERT_TRUE(zed::file::write(paths.back().c_str(), std::string(file_size, 'a' + i % 26)));
+    }
+
+    constexpr size_t iterations = 20 * files;
+    size_t total = 0;
+    report("std::ifstream", measure_ns(iterations, [&](size_t i) {
+        std::ifstream fs(paths[i % files], std::ios::binary);
+        std::stringstream ss;
+        ss << fs.rdbuf();
+        total += ss.str().length();
+    }), "file");
+    report("fopen + fseek + fread", measure_ns(iterations, [&](size_t i) {
+        FILE *fp = fopen(paths[i % files].c_str(), "rb");
+        fseek(fp, 0, SEEK_END);
+        std::string s(ftell(fp), '\0');
+        fseek(fp, 0, SEEK_SET);
+        s.resize(fread(s.data(), 1, s.length(), fp));
+        fclose(fp);
+        total += s.length();
+    }), "file");
+    std::string buffer;
+    report("zed::file::read_into (reused)", measure_ns(iterations, [&](size_t i) {
+        zed::file::read_into(paths[i % files].c_str(), buffer);
+        total += buffer.length();
+    }), "file");
+
+    for (const std::string &path : paths)
+        ::unlink(path.c_str());
+    ::rmdir(dir);
+    ASSERT_EQ(total, 3 * iterations * file_size);
+}
+#endif
+
+#ifdef _Z_OS_POSIX
+TEST(INIViews, DISABLED_BenchmarkLargeFile)
+{
+    constexpr size_t sections = 1000, keys_per_section = 1000;
+
+    std::string ini;
+    for (size_t i = 0; i < sections; ++i)
+    {
+        ini.append("[section").append(std::to_string(i)).append("]\n");
+        for (size_t j = 0; j < keys_per_section; ++j)
+        {
+            ini.append("key").append(std::to_string(j)).append(" = ");
+            if (0 == j % 16)
+                ini.append("\"escaped\\tvalue ").append(std::to_string(i * j)).append("\"\n");
+            else
+                ini.append("value ").append(std::to_string(i * j)).append(" ; comment\n");
+        }
+    }
+
+    char path[] = "/tmp/zed_ini_bench_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, ini.data(), ini.length()), static_cast<ssize_t>(ini.length()));
+    ::close(fd);
+    printf("  %zu keys, %zu MB\n", sections * keys_per_section, ini.length() / (1024 * 1024));
+
+    constexpr size_t iterations = 3;
+    size_t found = 0;
+    report("zed::ini_data (read + parse_string)", measure_ns(iterations, [&](size_t) {
+        std::string s;
+        FILE *fp = fopen(path, "rb");
+        s.resize(ini.length());
+        s.resize(fread(s.data(), 1, s.length(), fp));
+        fclose(fp);
+        found += nullptr != zed::ini_data::parse_string(s).get_section("section999");
+    }) / (sections * keys_per_section), "key");
+    report("zed::ini_view::open", measure_ns(iterations, [&](size_t) {
+        zed::ini_view view;
+        view.open(path);
+        found += view.size() == sections * keys_per_section;
+    }) / (sections * keys_per_section), "key");
+    ::unlink(path);
+    ASSERT_EQ(found, 2 * iterations);
+}
+#endif
@@ -8,10 +8,25 @@
 // Copyright (C) 2021 MingYang Software Technology.
 // -------------------------------------------------
 
+#include <memory_resource>
+#include <thread>
+#include <unordered_set>
 #include <gtest/gtest.h>
+#include "zed/config_watcher.hpp"
+#include "zed/file/mapped_file.hpp"
+#include "zed/file/parser_source.hpp"
+#include "zed/file/watcher.hpp"
 #include "zed/net/http_codecs.hpp"
 #include "zed/parsers/ini.hpp"
+#include "zed/parsers/ini_schema.hpp"
+#include "zed/parsers/ini_view.hpp"
+#include "zed/string/builder.hpp"
+#include "zed/string/conv.hpp"
 #include "zed/string/format.hpp"
+#include "zed/string/inline_string.hpp"
+#include "zed/string/parser.hpp"
+#include "zed/string/replacer.hpp"
+#include "zed/string/utf8.hpp"
 
 TEST(HTTPCodecs, DecodesAndEncodesCorrectly)
 {
@@ -62,6 +77,746 @@ TEST(Formatters, FormatsCorrectly)
     ASSERT_EQ(std::string("Hello, 123!").compare(zed::sequence_format("{}, {}!", "Hello", 123)), 0);
 }
 
+TEST(Formatters, FormatsLiteralsCorrectly)
+{
+    ASSERT_EQ(zed::sequence_format(ZFMT("{}, {}!"), "Hello", 123), "Hello, 123!");
+    ASSERT_EQ(zed::sequence_format(ZFMT("{} + {} = {}"), 1, 2, 3), "1 + 2 = 3");
+    ASSERT_EQ(zed::sequence_format(ZFMT("No placeholders.")), "No placeholders.");
+    ASSERT_EQ(zed::sequence_format(ZFMT("{}{"), 42), "42{");
+}
+
+TEST(Formatters, FormatsNumbersCorrectly)
+{
+    zed::number_buffer buf;
+    ASSERT_EQ(zed::format_number(buf, 0), "0");
+    ASSERT_EQ(zed::format_number(buf, -2147483647 - 1), "-2147483648");
+    ASSERT_EQ(zed::format_number(buf, 18446744073709551615ull), "18446744073709551615");
+    ASSERT_EQ(zed::format_number(buf, 0.1), "0.1");
+    ASSERT_EQ(zed::format_number(buf, -1.5f), "-1.5");
+    ASSERT_EQ(zed::sequence_format("{}/{}/{}", -42, 1234567890123ll, 2.5), "-42/1234567890123/2.5");
+}
+
+TEST(Formatters, FormatsSpecsCorrectly)
+{
+    ASSERT_EQ(zed::sequence_format("[{:08x}]", 48879), "[0000beef]");
+    ASSERT_EQ(zed::sequence_format("[{:#X}]", 255), "[0XFF]");
+    ASSERT_EQ(zed::sequence_format("[{:.3f}]", 3.14159), "[3.142]");
+    ASSERT_EQ(zed::sequence_format("[{:>6}]", "abc"), "[   abc]");
+    ASSERT_EQ(zed::sequence_format("[{:*^7}]", 42), "[**42***]");
+    ASSERT_EQ(zed::sequence_format("[{:+05}]", 7), "[+0007]");
+    ASSERT_EQ(zed::sequence_format(ZFMT("[{:<4}|{:.2s}]"), -1, "xyz"), "[-1  |xy]");
+}
+
+TEST(Formatters, CachesRuntimeFormats)
+{
+    char fmt[16] = "{}-{:03}";
+    for (int i = 0; i < 3; ++i)
+        ASSERT_EQ(zed::sequence_format(fmt, "a", i), "a-00" + std::to_string(i));
+
+    strcpy(fmt, "{:>3}");
+    ASSERT_EQ(zed::sequence_format(fmt, 7), "  7");
+
+    // Invalid specs are ignored.
+    strcpy(fmt, "{:4000000000}");
+    ASSERT_EQ(zed::sequence_format(fmt, 7), "7");
+    strcpy(fmt, "{:.9999999999}");
+    ASSERT_EQ(zed::sequence_format(fmt, "abc"), "abc");
+}
+
+TEST(StringComparisons, ComparesLongStringsCorrectly)
+{
+    const std::string s1 = "Content-Type: application/x-www-form-urlencoded; charset=UTF-8";
+    std::string s2 = s1;
+    ASSERT_TRUE(zed::strequ(s1, s2));
+    ASSERT_TRUE(zed::strequ(s1.c_str(), std::string_view(s2)));
+    s2.back() = '9';
+    ASSERT_FALSE(zed::strequ(s1.c_str(), s2.c_str()));
+    ASSERT_EQ(zed::strcmp(s1, s2), -1);
+    ASSERT_EQ(zed::strcmp(s2.c_str(), s1.c_str()), 1);
+    ASSERT_EQ(zed::strcmp(s1.c_str(), "Content-Type"), 1);
+    ASSERT_EQ(zed::strcmp(std::string_view("Content-Type"), s1), -1);
+}
+
+TEST(StringComparisons, ComparesIgnoringCaseCorrectly)
+{
+    const std::string s1 = "Access-Control-Allow-Credentials: TRUE; Access-Control-Max-Age";
+    const std::string s2 = "access-control-allow-credentials: true; ACCESS-CONTROL-MAX-AGE";
+    ASSERT_TRUE(zed::striequ(s1, s2));
+    ASSERT_TRUE(zed::striequ(s1.c_str(), s2.c_str()));
+    ASSERT_EQ(zed::stricmp(s1.c_str(), std::string_view(s2)), 0);
+    ASSERT_FALSE(zed::striequ(s1, "access-control-allow-credentials"));
+    ASSERT_EQ(zed::stricmp(s1.c_str(), "access-control-allow-credentials"), 1);
+    ASSERT_EQ(zed::stricmp("Sec-Fetch-Dest", "sec-fetch-mode"), -1);
+    ASSERT_FALSE(zed::striequ("[", "{"));
+}
+
+TEST(StringSplitting, SplitsLazilyCorrectly)
+{
+    std::vector<std::string> pieces;
+    for (const zed::string_piece<char> &piece : zed::split_view("a=1& b=2 &&  &c", "&"))
+        pieces.emplace_back(piece);
+    ASSERT_EQ(pieces, std::vector<std::string>({ "a=1", "b=2", "c" }));
+
+    std::string header = "gzip, deflate, br";
+    size_t count = 0;
+    zed::for_each_split(header, ", ", [&count](const zed::string_piece<char> &) {
+        ++count;
+    });
+    ASSERT_EQ(count, 3);
+
+    zed::string_piece<char> found;
+    zed::for_each_split(header, ",", [&found](const zed::string_piece<char> &piece) {
+        found = piece;
+        return piece != "deflate";
+    });
+    ASSERT_EQ(found, "deflate");
+
+    ASSERT_EQ(zed::split(std::string(" , ,"), ",").size(), 0);
+    ASSERT_TRUE(zed::split_view("", ",").begin() == zed::split_view("", ",").end());
+}
+
+TEST(StringSearching, FindsCorrectly)
+{
+    std::string payload(1000, 'a');
+    payload.append("\r\n--boundary\r\n").append(100, 'b');
+    const std::string_view s(payload);
+    ASSERT_EQ(zed::find_string(s, std::string_view("\r\n--boundary\r\n")), 1000);
+    ASSERT_EQ(zed::find_string(s, std::string_view("--boundarx")), std::string_view::npos);
+    ASSERT_EQ(zed::find_char(s, 'b', 1020), 1020);
+    ASSERT_EQ(zed::find_first_of(s, std::string_view("\n-")), 1001);
+    ASSERT_EQ(zed::replace(std::string("a--b--c"), "+", "--"), "a+b+c");
+
+    const char data[] = "[section]\nkey = \"escaped \\\"value\\\"\" ; comment\n";
+    zed::ini_data ini = zed::ini_data::parse_string(std::string(data));
+    ASSERT_EQ(ini.get_string("section", "key"), "escaped \"value\"");
+}
+
+TEST(StringReplacing, ReplacesMultiplePatternsCorrectly)
+{
+    zed::multi_replacer<char> escaper({ { "&", "&amp;" }, { "<", "&lt;" }, { ">", "&gt;" }, { "\"", "&quot;" } });
+    ASSERT_EQ(escaper.replace("<a href=\"?x=1&y=2\">"), "&lt;a href=&quot;?x=1&amp;y=2&quot;&gt;");
+    ASSERT_EQ(escaper.replace("nothing to escape"), "nothing to escape");
+
+    // Leftmost first, then longest.
+    zed::multi_replacer<char> replacer({ { "bc", "1" }, { "abcd", "2" }, { "ab", "3" }, { "abc", "4" } });
+    ASSERT_EQ(replacer.replace("abcde bcd abc"), "2e 1d 4");
+
+    std::string dst = "> ";
+    zed::multi_replacer<char>({ { "{{name}}", "ZED" } }).replace("Hello, {{name}}!", dst);
+    ASSERT_EQ(dst, "> Hello, ZED!");
+}
+
+TEST(CharSets, ClassifiesCorrectly)
+{
+    constexpr zed::char_set separators(",;");
+    static_assert(separators.contains(';') && !separators.contains(' '));
+    static_assert(zed::ascii_whitespace<char>::set.contains('\v'));
+    ASSERT_FALSE((~separators).contains(','));
+    ASSERT_FALSE(separators.contains(L'\x2c2c'));
+    ASSERT_FALSE(zed::isspace('\0'));
+
+    std::string s = std::string(40, ' ') + "value" + std::string(40, '\t');
+    ASSERT_EQ(zed::trim(s), "value");
+    ASSERT_EQ(zed::find_last_not_of(zed::string_piece<char>(s), zed::ascii_whitespace<char>::set), 44);
+    ASSERT_TRUE(zed::strequ(zed::trim_right(" \t "), ""));
+}
+
+TEST(CaseConversions, ConvertsCorrectly)
+{
+    const std::string host = "WWW.Example-Host.ORG:8080/Path?Query=\xC3\x89t\xC3\xA9";
+    ASSERT_EQ(zed::to_lower_ascii(host), "www.example-host.org:8080/path?query=\xC3\x89t\xC3\xA9");
+    ASSERT_EQ(zed::to_upper_ascii("content-type"), "CONTENT-TYPE");
+
+    std::string key = "Accept-Encoding";
+    zed::to_lower_ascii(&key);
+    ASSERT_EQ(key, "accept-encoding");
+
+    ASSERT_TRUE(zed::all_ascii(key));
+    ASSERT_FALSE(zed::all_ascii(host));
+    ASSERT_TRUE(zed::all_digits(std::string(100, '7')));
+    ASSERT_FALSE(zed::all_digits("12345678901234567890123456789012345:"));
+    ASSERT_TRUE(zed::isxdigit('f') && !zed::isxdigit('g') && zed::ispunct('~') && zed::isalnum('Z'));
+}
+
+TEST(UnicodeConversions, ConvertsCorrectly)
+{
+    const std::string ascii(100, 'a');
+    const std::string text = ascii + "\xE4\xBD\xA0\xE5\xA5\xBD, \xF0\x9F\x98\x80!" + ascii;
+    const std::u16string u16 = zed::utf8_to_utf16(text);
+    ASSERT_EQ(u16, std::u16string(100, u'a') + u"\u4F60\u597D, \U0001F600!" + std::u16string(100, u'a'));
+    ASSERT_EQ(zed::utf8_to_utf32(text), std::u32string(100, U'a') + U"\u4F60\u597D, \U0001F600!" + std::u32string(100, U'a'));
+    ASSERT_EQ(zed::utf16_to_utf8(zed::string_piece<char16_t>(u16)), text);
+
+    // Ill-formed input is replaced, not rejected.
+    ASSERT_EQ(zed::utf8_to_utf16("a\xC0\xAF" "b\xED\xA0\x80" "c\xF0\x9F\x98"), u"a\uFFFD\uFFFDb\uFFFD\uFFFD\uFFFDc\uFFFD");
+    const char16_t lone_surrogate[] = { u'x', 0xD83D, u'y' };
+    ASSERT_EQ(zed::utf16_to_utf8(zed::string_piece<char16_t>(lone_surrogate, 3)), "x\xEF\xBF\xBDy");
+
+    std::u16string dst = u">";
+    zed::utf8_to_utf16("ok", dst);
+    ASSERT_EQ(dst, u">ok");
+}
+
+TEST(UTF8Validation, ValidatesCorrectly)
+{
+    std::string text(100, 'a');
+    text.append("\xC3\xA9\xE4\xBD\xA0\xF0\x9F\x98\x80\xEF\xBF\xBD");
+    text.append(100, 'b');
+    ASSERT_TRUE(zed::validate_utf8(text));
+    ASSERT_TRUE(zed::validate_utf8(""));
+
+    const char *invalid[] = { "\x80", "\xC0\xAF", "\xE0\x80\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF8\x88\x80\x80\x80", "\xE4\xBD" };
+    for (const char *s : invalid)
+    {
+        ASSERT_FALSE(zed::validate_utf8(s));
+        ASSERT_EQ(zed::find_invalid_utf8(text + s + text), text.length());
+    }
+
+    // An incomplete sequence at the end of a SIMD block.
+    std::string truncated(63, 'x');
+    truncated.append("\xE4" "abc");
+    truncated.append(100, 'y');
+    ASSERT_EQ(zed::find_invalid_utf8(truncated), 63);
+
+    ASSERT_EQ(zed::repair_utf8("a\xC0\xAF" "b\xF0\x9F\x98"), "a\xEF\xBF\xBD\xEF\xBF\xBD" "b\xEF\xBF\xBD");
+    std::string s = text;
+    ASSERT_FALSE(zed::repair_utf8(&s));
+    s.append("\xFF");
+    ASSERT_TRUE(zed::repair_utf8(&s));
+    ASSERT_EQ(s, text + "\xEF\xBF\xBD");
+}
+
+TEST(InlineStrings, StoresCorrectly)
+{
+    static_assert(std::is_trivially_copyable<zed::inline_string<31>>::value, "Should be trivially copyable!");
+    static_assert(32 == sizeof(zed::inline_string<31>), "Unexpected size!");
+
+    const zed::inline_string<31> s("Content-Type");
+    ASSERT_TRUE(zed::strequ(s, "Content-Type"));
+    ASSERT_TRUE(zed::striequ(s, "content-type"));
+    ASSERT_EQ(zed::string_piece<char>(s), "Content-Type");
+
+    const std::string long_name(40, 'x');
+    zed::inline_string<31> rejected("abc");
+    ASSERT_FALSE(rejected.assign(long_name));
+    ASSERT_EQ(zed::string_piece<char>(rejected), "abc");
+
+    zed::inline_string<4, zed::inline_spill::truncate> truncated;
+    ASSERT_FALSE(truncated.assign("abcdef"));
+    ASSERT_EQ(zed::string_piece<char>(truncated), "abcd");
+
+    zed::inline_string<15, zed::inline_spill::heap> spilled(long_name), copied(spilled), moved(std::move(copied));
+    ASSERT_TRUE(zed::strequ(spilled, long_name));
+    ASSERT_TRUE(copied.empty());
+    ASSERT_TRUE(spilled == moved);
+    moved = "short";
+    ASSERT_TRUE(zed::strequ(moved, "short"));
+
+    std::unordered_set<zed::inline_string<31>> set = { "a", "b", "Content-Type" };
+    ASSERT_EQ(set.count(s), 1);
+
+    const zed::form_data form = zed::url_decode("q=zed&flag&" + long_name + "=1");
+    ASSERT_EQ(form.size(), 3);
+    ASSERT_EQ(form.at("q"), "zed");
+    ASSERT_EQ(form.at("flag"), "");
+    ASSERT_EQ(form.at(long_name), "1");
+
+    const std::unordered_map<std::string, std::string> std_form = zed::url_decode<std::unordered_map<std::string, std::string>>("q=zed&flag");
+    ASSERT_EQ(std_form.at("q"), "zed");
+    ASSERT_EQ(zed::url_encode({ { "k", "v" } }), "k=v");
+}
+
+TEST(StringBuilders, BuildsCorrectly)
+{
+    char arena[4096];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena));
+    zed::string_builder builder(&resource);
+
+    std::string expected;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        std::string s(i % 300, static_cast<char>('a' + i % 26));
+        builder.append(s);
+        expected.append(s);
+        builder.push_back('|');
+        expected.push_back('|');
+    }
+    builder.reserve_hint(5000);
+    builder.append(5000, 'z');
+    expected.append(5000, 'z');
+    char *p = builder.prepare(8);
+    memcpy(p, "prepared", 8);
+    builder.commit(8);
+    expected.append("prepared");
+
+    ASSERT_EQ(builder.size(), expected.size());
+    ASSERT_EQ(builder.str(), expected);
+
+    std::string joined;
+    builder.for_each_chunk([&joined](const zed::string_piece<char> &s) { joined.append(s.data(), s.length()); });
+    ASSERT_EQ(joined, expected);
+#ifdef _Z_OS_POSIX
+    size_t total = 0;
+    for (const struct iovec &v : builder.iovecs())
+        total += v.iov_len;
+    ASSERT_EQ(total, expected.size());
+#endif
+
+    builder.clear();
+    ASSERT_TRUE(builder.empty());
+    ASSERT_EQ(zed::encode_uri_component("a b&c=\xE4\xBD\xA0"), "a+b%26c%3D%E4%BD%A0");
+    ASSERT_EQ(zed::url_encode(std::unordered_map<std::string, std::string>{ { "k", "v w" } }), "k=v+w");
+}
+
+TEST(ParserStreams, ScansCorrectly)
+{
+    constexpr zed::char_set digits("0123456789");
+    const std::string text = "  1234 apples; 56 pears";
+
+    zed::basic_parser_stream<zed::parser_string_source> stream(text);
+    ASSERT_EQ(stream.peek(), '1');
+    ASSERT_EQ(stream.skip_while(digits), "1234");
+    ASSERT_EQ(stream.take_until(zed::char_set(";")), " apples");
+    ASSERT_EQ(stream.advance(), ' ');
+    ASSERT_EQ(stream.parsed_count(), 14);
+    ASSERT_EQ(stream.take_until(zed::char_set("!")), " 56 pears");
+    ASSERT_EQ(stream.current_char(), EOF);
+
+    // Virtual streams behave the same.
+    zed::parser_psz_stream psz_stream(text.c_str());
+    zed::parser_stream &s = psz_stream;
+    ASSERT_EQ(s.peek(), '1');
+    ASSERT_EQ(s.skip_while(digits), "1234");
+    ASSERT_EQ(s.skip_until(";"), ';');
+    ASSERT_EQ(s.take_until(digits), "; ");
+    ASSERT_EQ(s.parsed_count(), 15);
+    ASSERT_EQ(s.skip_until(zed::char_set()), EOF);
+
+    const std::string ini = "[s]\nk = v\n";
+    zed::parser_string_stream ini_stream(ini);
+    ASSERT_EQ(zed::ini_data::parse_stream(ini_stream).get_string("s", "k"), "v");
+}
+
+TEST(ParserStreams, KeepsSubclassingInterface)
+{
+    // Streams written against the original base class still work.
+    class fenced_stream final : public zed::parser_stream
+    {
+    public:
+        explicit fenced_stream(const char *psz) : parser_stream(psz) {}
+    private:
+        int current_char(void) const override { return '\0' != *m_current && '#' != *m_current ? *m_current : EOF; }
+        void advance_internal(void) override { ++m_current; }
+    };
+
+    fenced_stream stream("[s]\nk = v\n#[t]\nk = w\n");
+    zed::ini_data data = zed::ini_data::parse_stream(stream);
+    ASSERT_EQ(data.get_string("s", "k"), "v");
+    ASSERT_EQ(data.get_section("t"), nullptr);
+    ASSERT_EQ(stream.parsed_count(), 10);
+}
+
+#ifdef _Z_OS_POSIX
+TEST(ParserStreams, RefillsFromFiles)
+{
+    std::string ini = "; comment\n";
+    for (int i = 0; i < 100; ++i)
+        ini += "[section" + std::to_string(i) + "]\nkey = \"a value longer than the window\"\n";
+
+    FILE *fp = tmpfile();
+    ASSERT_NE(fp, nullptr);
+    ASSERT_EQ(::write(fileno(fp), ini.data(), ini.length()), static_cast<ssize_t>(ini.length()));
+    ::lseek(fileno(fp), 0, SEEK_SET);
+
+    // Tiny windows make tokens straddle refills.
+    zed::basic_parser_stream<zed::parser_file_source> stream(fileno(fp), 16);
+    zed::ini_data data = zed::ini_data::parse_stream(stream);
+    ASSERT_EQ(stream.parsed_count(), ini.length());
+    ASSERT_EQ(data.get_string("section0", "key"), "a value longer than the window");
+    ASSERT_EQ(data.get_string("section99", "key"), "a value longer than the window");
+    fclose(fp);
+}
+#endif
+
+#ifdef _Z_OS_POSIX
+TEST(INIViews, MatchesINIData)
+{
+    const std::string ini =
+        "[s1]\n"
+        "k1 = v1 ; comment\n"
+        "k2 = \"quoted\\tvalue\"\n"
+        "k3 = 'single'\n"
+        "k1 = duplicated\n"
+        "n = +42\n"
+        "[ s2 ]\n"
+        "k = v2\n"
+        "[s1]\n"
+        "k4 = merged\n";
+
+    char path[] = "/tmp/zed_ini_view_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, ini.data(), ini.length()), static_cast<ssize_t>(ini.length()));
+    ::close(fd);
+
+    zed::ini_view view;
+    ASSERT_TRUE(view.open(path));
+    ::unlink(path);
+
+    zed::ini_data data = zed::ini_data::parse_string(ini);
+    for (const char *name : { "k1", "k2", "k3", "k4", "n", "none" })
+        ASSERT_EQ(std::to_string(view.get_string("s1", name, "?")), data.get_string("s1", name, "?"));
+    ASSERT_EQ(view.get_string("s2", "k"), "v2");
+    ASSERT_EQ(view.get_int("s1", "n", 0), 42);
+    ASSERT_EQ(view.get_int("s1", "k1", -1), -1);
+    ASSERT_EQ(view.size(), 6);
+
+    view.close();
+    ASSERT_FALSE(view.open("/nonexistent/zed.ini"));
+}
+#endif
+
+TEST(FrozenINIData, LooksUpCorrectly)
+{
+    std::string ini = "[empty]\n[s]\nn = 42\nbad = 4x\n";
+    for (int i = 0; i < 100; ++i)
+        ini += "[section" + std::to_string(i % 7) + "]\nkey" + std::to_string(i) + " = value" + std::to_string(i) + "\n";
+
+    zed::ini_data data = zed::ini_data::parse_string(ini);
+    zed::frozen_ini_data frozen = data.freeze();
+    ASSERT_EQ(frozen.size(), 102);
+    for (int i = 0; i < 100; ++i)
+    {
+        const std::string sec = "section" + std::to_string(i % 7), key = "key" + std::to_string(i);
+        ASSERT_EQ(frozen.get_string(sec, key), data.get_string(sec.c_str(), key.c_str()));
+        ASSERT_FALSE(frozen.contains(sec, key + "x"));
+    }
+    ASSERT_EQ(frozen.get_int("s", "n", 0), 42);
+    ASSERT_EQ(frozen.get_int("s", "bad", 0), 4);
+    ASSERT_EQ(frozen.get_int("s", "none", -1), -1);
+    ASSERT_EQ(data.get_int("s", "n", 0), 42);
+    ASSERT_EQ(data.get_int("s", "bad", 0), 4);
+    ASSERT_EQ(data.get_int("section0", "key0", -1), -1);
+    ASSERT_EQ(frozen.get_string("empty", "n", "def"), "def");
+    ASSERT_FALSE(frozen.contains("section1", "key0"));
+
+    zed::frozen_ini_data none = zed::ini_data::parse_cstr("").freeze();
+    ASSERT_FALSE(none.contains("s", "n"));
+}
+
+TEST(INISchemas, BindsCorrectly)
+{
+    struct config {
+        int port = 0;
+        unsigned short backlog = 0;
+        double ratio = 0;
+        bool verbose = false;
+        std::string host;
+        long long limit = 0;
+    };
+
+    zed::ini_schema<config> schema;
+    schema.bind("server", "port", &config::port, 8080, 1, 65535)
+        .bind("server", "backlog", &config::backlog, 16, 1, 1024)
+        .bind("server", "ratio", &config::ratio, 0.5)
+        .bind("server", "verbose", &config::verbose, false)
+        .bind("server", "host", &config::host, "localhost")
+        .bind("limits", "max", &config::limit, -1);
+
+    config c;
+    zed::ini_bind_report report;
+    zed::ini_data data = zed::ini_data::parse_cstr("[server]\nport = 443\nbacklog = 4096\nratio = 0.25\nverbose = Yes\n[limits]\nmax = 12x\n");
+    ASSERT_FALSE(schema.apply(data, c, &report));
+    ASSERT_EQ(c.port, 443);
+    ASSERT_EQ(c.backlog, 16);
+    ASSERT_EQ(c.ratio, 0.25);
+    ASSERT_TRUE(c.verbose);
+    ASSERT_EQ(c.host, "localhost");
+    ASSERT_EQ(c.limit, -1);
+
+    ASSERT_EQ(report.errors.size(), 2);
+    ASSERT_EQ(report.errors[0].type, zed::ini_bind_error::out_of_range);
+    ASSERT_EQ(report.errors[0].name, "backlog");
+    ASSERT_EQ(report.errors[1].type, zed::ini_bind_error::malformed);
+    ASSERT_EQ(report.errors[1].value, "12x");
+
+    // Frozen data binds the same.
+    config f;
+    ASSERT_FALSE(schema.apply(data.freeze(), f));
+    ASSERT_EQ(f.port, 443);
+    ASSERT_EQ(f.ratio, 0.25);
+
+    ASSERT_TRUE(schema.apply(zed::ini_data::parse_cstr("[server]\nport = +80\nverbose = off\n"), c));
+    ASSERT_EQ(c.port, 80);
+    ASSERT_FALSE(c.verbose);
+    ASSERT_EQ(c.ratio, 0.5);
+}
+
+#ifdef _Z_OS_LINUX
+TEST(ConfigWatchers, ReloadsOnChanges)
+{
+    char dir[] = "/tmp/zed_config_XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string path = std::string(dir) + "/app.ini", tmp = path + ".tmp";
+
+    auto write_file = [](const std::string &path, const char *content) {
+        FILE *fp = std::fopen(path.c_str(), "w");
+        ASSERT_NE(fp, nullptr);
+        std::fputs(content, fp);
+        std::fclose(fp);
+    };
+    write_file(path, "[server]\nport = 80\n");
+
+    zed::config_watcher watcher(path.c_str(), std::chrono::milliseconds(20), [](const zed::ini_data &data) {
+        return data.get_int("server", "port", 0) > 0;
+    });
+    zed::config_watcher::reader config(watcher);
+    ASSERT_EQ(config->get_int("server", "port", 0), 80);
+    ASSERT_EQ(watcher.version(), 1);
+
+    // Replaced by renaming, as editors do.
+    write_file(tmp, "[server]\nport = 8080\n");
+    ASSERT_EQ(::rename(tmp.c_str(), path.c_str()), 0);
+    for (int i = 0; i < 200 && 8080 != config->get_int("server", "port", 0); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(config->get_int("server", "port", 0), 8080);
+
+    // Written in place, not reloaded until closed, however long the writer takes.
+    int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "[server]\nport = 9", 17), 17);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20 * zed::file_watcher::max_latency_factor * 2));
+    ASSERT_EQ(watcher.version(), 2);
+    ASSERT_EQ(::write(fd, "090\n", 4), 4);
+    ::close(fd);
+    for (int i = 0; i < 200 && 9090 != config->get_int("server", "port", 0); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(config->get_int("server", "port", 0), 9090);
+
+    // Rejected by the validator.
+    write_file(tmp, "[server]\nport = -1\n");
+    ASSERT_EQ(::rename(tmp.c_str(), path.c_str()), 0);
+    ASSERT_FALSE(watcher.reload());
+    ASSERT_EQ(watcher.snapshot()->get_int("server", "port", 0), 9090);
+
+    ::unlink(path.c_str());
+
+    // Missing files start empty, and are loaded once they appear.
+    zed::config_watcher missing(path.c_str(), std::chrono::milliseconds(20));
+    zed::config_watcher::reader missing_config(missing);
+    ASSERT_EQ(missing.version(), 1);
+    ASSERT_EQ(missing_config->get_int("server", "port", -1), -1);
+    write_file(path, "[server]\nport = 81\n");
+    for (int i = 0; i < 200 && 81 != missing_config->get_int("server", "port", 0); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(missing_config->get_int("server", "port", 0), 81);
+
+    ::unlink(path.c_str());
+    ::rmdir(dir);
+}
+#endif
+
+#ifdef _Z_OS_LINUX
+TEST(FileWatchers, DeliversCoalescedChanges)
+{
+    char dir[] = "/tmp/zed_watcher_XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string root(dir), sub = root + "/sub";
+
+    zed::mutex mutex;
+    std::vector<zed::file_change> changes;
+    auto wait_for = [&](const std::string &path, zed::file_change::change_type type) {
+        for (int i = 0; i < 200; ++i)
+        {
+            if (auto _ = mutex.guard())
+            {
+                for (const zed::file_change &c : changes)
+                {
+                    if (c.path == path && c.type == type)
+                        return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    };
+
+    zed::file_watcher watcher([&](const zed::file_watcher::change_set &cs) {
+        auto _ = mutex.guard();
+        changes.insert(changes.end(), cs.begin(), cs.end());
+    }, std::chrono::milliseconds(20));
+    ASSERT_TRUE(watcher.watch(dir, true));
+    ASSERT_FALSE(watcher.watch("/nonexistent/zed"));
+
+    // Created and written in a burst, delivered once as created.
+    FILE *fp = std::fopen((root + "/a.txt").c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    std::fputs("a", fp);
+    std::fclose(fp);
+    ASSERT_TRUE(wait_for(root + "/a.txt", zed::file_change::created));
+    if (auto _ = mutex.guard())
+    {
+        ASSERT_EQ(changes.size(), 1);
+        changes.clear();
+    }
+
+    // Subdirectories are watched as they are created.
+    ASSERT_EQ(::mkdir(sub.c_str(), 0700), 0);
+    ASSERT_TRUE(wait_for(sub, zed::file_change::created));
+    fp = std::fopen((sub + "/b.txt").c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    std::fclose(fp);
+    ASSERT_TRUE(wait_for(sub + "/b.txt", zed::file_change::created));
+
+    ASSERT_EQ(::unlink((sub + "/b.txt").c_str()), 0);
+    ASSERT_TRUE(wait_for(sub + "/b.txt", zed::file_change::removed));
+
+    watcher.unwatch(dir);
+    ::rmdir(sub.c_str());
+    ::unlink((root + "/a.txt").c_str());
+    ::rmdir(dir);
+}
+#endif
+
+#ifdef _Z_OS_POSIX
+TEST(MappedFiles, MapsAndViews)
+{
+    char path[] = "/tmp/zed_mapped_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+
+    zed::mapped_file file;
+    ASSERT_TRUE(file.open(path));
+    ASSERT_TRUE(file.is_open());
+    ASSERT_TRUE(file.view().empty());
+
+    ASSERT_EQ(::write(fd, "hello, world", 12), 12);
+    ::close(fd);
+    ASSERT_TRUE(file.open(path, zed::mapped_file::read_write, zed::mapped_file::will_need | zed::mapped_file::populate));
+    ASSERT_EQ(file.view(), "hello, world");
+    ASSERT_EQ(file.view(7), "world");
+    ASSERT_EQ(file.view(7, 2), "wo");
+    ASSERT_EQ(file.view(20, 2), "");
+    file.advise(7, 100, zed::mapped_file::sequential | zed::mapped_file::huge_pages);
+
+    file.data()[0] = 'H';
+    ASSERT_TRUE(file.flush());
+    zed::mapped_file moved(std::move(file));
+    ASSERT_FALSE(file.is_open());
+    moved.close();
+
+    ASSERT_TRUE(file.open(path, zed::mapped_file::read_only, zed::mapped_file::sequential));
+    ASSERT_EQ(file.view(), "Hello, world");
+    ::unlink(path);
+
+    ASSERT_FALSE(file.open("/nonexistent/zed"));
+    ASSERT_FALSE(file.is_open());
+}
+#endif
+
+#ifdef _Z_OS_POSIX
+TEST(Files, ReadsAndWrites)
+{
+    char path[] = "/tmp/zed_file_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    std::string s = "stale";
+    ASSERT_TRUE(zed::file::read(path, s));
+    ASSERT_TRUE(s.empty());
+
+    // Large enough to be preallocated.
+    std::string data(zed::file::preallocation_threshold + 123, '\0');
+    for (size_t i = 0; i < data.length(); ++i)
+        data[i] = static_cast<char>(i * 31);
+    ASSERT_TRUE(zed::file::write(path, data));
+    ASSERT_TRUE(zed::file::read(path, s));
+    ASSERT_EQ(s, data);
+
+    ASSERT_TRUE(zed::file::write(path, std::string("small")));
+    std::vector<char> buffer;
+    buffer.reserve(4096);
+    const char *p = buffer.data();
+    ASSERT_TRUE(zed::file::read_into(path, buffer));
+    ASSERT_EQ(std::string(buffer.begin(), buffer.end()), "small");
+    ASSERT_EQ(buffer.data(), p); // Capacity reused.
+    ::unlink(path);
+
+#ifdef _Z_OS_LINUX
+    // Sizes are unknown.
+    ASSERT_TRUE(zed::file::read("/proc/self/status", s));
+    ASSERT_NE(s.find("Pid:"), std::string::npos);
+#endif
+
+    ASSERT_FALSE(zed::file::read("/nonexistent/zed", s));
+    ASSERT_FALSE(zed::file::write("/nonexistent/zed", s));
+}
+#endif
+
+#ifdef _Z_OS_LINUX
+TEST(Files, WritesAtomically)
+{
+    char dir[] = "/tmp/zed_atomic_XXXXXX";
+    ASSERT_NE(::mkdtemp(dir), nullptr);
+    const std::string path = std::string(dir) + "/state";
+
+    std::string s;
+    ASSERT_TRUE(zed::file::write_atomic(path.c_str(), std::string("old")));
+    ASSERT_TRUE(zed::file::write_atomic(path.c_str(), std::string("new")));
+    ASSERT_TRUE(zed::file::read(path.c_str(), s));
+    ASSERT_EQ(s, "new");
+    ASSERT_FALSE(zed::file::write_atomic("/nonexistent/zed", s));
+
+    // Replaced files keep their modes and owners.
+    struct stat st;
+    ASSERT_EQ(::chmod(path.c_str(), 0640), 0);
+    bool chowned = 0 == ::geteuid() && 0 == ::chown(path.c_str(), 1234, 5678);
+    ASSERT_TRUE(zed::file::write_atomic(path.c_str(), std::string("kept")));
+    ASSERT_EQ(::stat(path.c_str(), &st), 0);
+    ASSERT_EQ(st.st_mode & 07777, 0640);
+    if (chowned)
+    {
+        ASSERT_EQ(st.st_uid, 1234);
+        ASSERT_EQ(st.st_gid, 5678);
+    }
+
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded{ 0 };
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&, i] {
+            std::string p = std::string(dir) + "/state" + std::to_string(i);
+            for (int j = 0; j < 4; ++j)
+                succeeded += zed::file::write_atomic(p.c_str(), std::to_string(i * j));
+        });
+    }
+    for (std::thread &t : threads)
+        t.join();
+    ASSERT_EQ(succeeded, 32);
+    for (int i = 0; i < 8; ++i)
+    {
+        ASSERT_TRUE(zed::file::read((std::string(dir) + "/state" + std::to_string(i)).c_str(), s));
+        ASSERT_EQ(s, std::to_string(i * 3));
+    }
+
+    // No temporary files left.
+    size_t entries = 0;
+    DIR *d = ::opendir(dir);
+    while (const dirent *e = ::readdir(d))
+    {
+        if ('.' != e->d_name[0])
+        {
+            ++entries;
+            ::unlink((std::string(dir) + "/" + e->d_name).c_str());
+        }
+    }
+    ::closedir(d);
+    ::rmdir(dir);
+    ASSERT_EQ(entries, 9);
+}
+#endif
+
 int main(int argc, char *argv[])
 {
     testing::InitGoogleTest(&argc, argv);